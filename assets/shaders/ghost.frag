@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+uniform vec3 color;
+
+// ghosts stack up where runs agree
+const float alpha = 0.12;
+
+void main()
+{
+    FragColor = vec4(color, alpha);
+}
@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec2 corner; // 0..1 over the square
+layout (location = 1) in vec2 offset; // per ghost, lower left corner
+
+uniform vec2 size;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(offset + corner * size, 0.0, 1.0);
+}
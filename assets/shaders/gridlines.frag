@@ -0,0 +1,12 @@
+#version 330 core
+
+out vec4 FragColor;
+
+in float v_alpha;
+
+uniform vec3 color;
+
+void main()
+{
+    FragColor = vec4(color, v_alpha);
+}
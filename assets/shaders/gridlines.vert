@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec3 pos;
+layout (location = 1) in float color_alpha;
+
+out float v_alpha;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(pos.xyz, 1.0);
+    v_alpha = color_alpha;
+}
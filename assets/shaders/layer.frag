@@ -0,0 +1,12 @@
+#version 330 core
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D layer; // what gl_layer rendered, color premultiplied by alpha
+
+void main()
+{
+    // back to straight alpha, the render queue blends with GL_SRC_ALPHA
+    vec4 texel = texture(layer, TexCoords);
+    FragColor = texel.a > 0.0 ? vec4(texel.rgb / texel.a, texel.a) : vec4(0.0);
+}
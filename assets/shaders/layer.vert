@@ -0,0 +1,13 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in vec2 texture_coordinates;
+
+out vec2 TexCoords;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(position.xy, 0.0, 1.0);
+    TexCoords = texture_coordinates;
+}
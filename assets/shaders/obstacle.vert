@@ -0,0 +1,16 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;        // where the corner was at spawn
+layout (location = 1) in float spawnScore;
+
+// the score this frame is drawn at, fractional between ticks
+uniform float ticks;
+
+#include "projection.glsl"
+
+void main()
+{
+    // Triangle::position_at: n ticks after spawning at score s it moved (n (300 + s) + n (n + 1) / 2) / 60
+    float n = max(ticks - spawnScore, 0.0);
+    float travel = (n * (300.0 + spawnScore) + n * (n + 1.0) * 0.5) / 60.0;
+    gl_Position = projection * vec4(aPos.x - travel, aPos.y, 1, 1);
+}
@@ -0,0 +1,11 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec4 v_color;
+
+uniform vec3 color; // tint for every particle in the draw
+
+void main()
+{
+    FragColor = vec4(color, 1.0) * v_color;
+}
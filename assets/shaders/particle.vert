@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec2 position;
+layout (location = 1) in float size;
+layout (location = 2) in vec4 particle_color;
+
+out vec4 v_color;
+
+// pixels per screen unit of the target drawn into, below 1 under dynamic resolution
+uniform float point_scale;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(position.xy, 0.0, 1.0);
+    gl_PointSize = size * point_scale;
+    v_color = particle_color;
+}
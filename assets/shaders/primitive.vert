@@ -0,0 +1,12 @@
+#version 330 core
+layout (location = 0) in vec2 aPos; // unit mesh
+
+// scale in xy, offset in zw
+uniform vec4 transform;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(aPos * transform.xy + transform.zw, 1, 1);
+}
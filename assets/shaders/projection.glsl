@@ -0,0 +1,2 @@
+// orthographic screen space projection, shared by every 2d shader
+uniform mat4 projection;
@@ -0,0 +1,9 @@
+#version 330 core
+layout (location = 0) in vec2 aPos;
+
+#include "projection.glsl"
+
+void main()
+{
+    gl_Position = projection * vec4(aPos.xy, 1, 1);
+}
@@ -0,0 +1,17 @@
+#version 330 core
+in vec2 TexCoords;
+out vec4 FragColor;
+
+uniform sampler2D text; // mono-colored bitmap image of the glyph
+uniform vec3 color; // color uniform for adjusting the text's final color
+
+void main()
+{
+    // we sample the 'r'ed component of the texture
+    // because thats where the texture's data is stored
+    // we put that value is the alpha value
+    // so that background pixels will be 0 (transparent)
+    // and character pixels will be visible (1)
+    vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
+    FragColor = vec4(color, 1.0) * sampled;
+}
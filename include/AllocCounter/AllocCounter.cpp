@@ -0,0 +1,71 @@
+#include "AllocCounter.h"
+
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    // per thread, a frame only sees what its own thread allocated, not the logger's or a worker's
+    thread_local std::uint64_t allocation_count = 0;
+}
+
+std::uint64_t get_allocation_count()
+{
+    return allocation_count;
+}
+
+void FrameAllocations::begin_frame()
+{
+    m_frame_start = get_allocation_count();
+}
+
+std::uint64_t FrameAllocations::get_count() const
+{
+    return get_allocation_count() - m_frame_start;
+}
+
+#ifdef GL_JUMP_COUNT_ALLOCATIONS
+
+void* operator new(std::size_t size)
+{
+    allocation_count++;
+    if (void* memory = std::malloc(size ? size : 1))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void* operator new(std::size_t size, std::align_val_t alignment)
+{
+    allocation_count++;
+    std::size_t align = static_cast<std::size_t>(alignment);
+    // aligned_alloc wants a non zero size that is a multiple of the alignment
+    if (void* memory = std::aligned_alloc(align, (size + align) / align * align))
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void* memory, std::size_t, std::align_val_t) noexcept
+{
+    std::free(memory);
+}
+
+#endif
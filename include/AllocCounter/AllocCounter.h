@@ -0,0 +1,30 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Optional global operator new hook, enabled with the CMake option
+ * GL_JUMP_COUNT_ALLOCATIONS. Counts every heap allocation made through
+ * new/delete, per thread, so a frame's allocation count can be checked
+ * without the other threads' allocations landing in it.
+ */
+#ifdef GL_JUMP_COUNT_ALLOCATIONS
+constexpr bool allocation_counting_enabled = true;
+#else
+constexpr bool allocation_counting_enabled = false;
+#endif
+
+// allocations the calling thread made since it started, always 0 when counting is disabled
+std::uint64_t get_allocation_count();
+
+// remembers the calling thread's count at the start of a frame
+class FrameAllocations
+{
+public:
+    void begin_frame();
+
+    std::uint64_t get_count() const;
+
+private:
+    std::uint64_t m_frame_start = 0;
+};
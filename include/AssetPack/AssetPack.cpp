@@ -0,0 +1,85 @@
+#include "AssetPack.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Logger/Logger.h"
+
+bool AssetPack::open(const std::string& path)
+{
+    m_entries = {};
+    if (!m_file.open(path))
+    {
+        return false;
+    }
+    std::span<const std::byte> data = m_file.get_data();
+
+    if (data.size() < sizeof(AssetPackHeader))
+    {
+        log_error("ASSET_PACK", "{} is too small", path);
+        m_file.close();
+        return false;
+    }
+    // the mapping is page aligned, so header and entries can be used in place
+    const auto* header = reinterpret_cast<const AssetPackHeader*>(data.data());
+    if (std::memcmp(header->magic, asset_pack_magic, sizeof(asset_pack_magic)) != 0 ||
+        header->version != asset_pack_version || header->file_size != data.size())
+    {
+        log_error("ASSET_PACK", "{} is not a version {} asset pack", path, asset_pack_version);
+        m_file.close();
+        return false;
+    }
+    if (header->toc_offset % alignof(AssetPackEntry) != 0 || header->toc_offset > data.size() ||
+        header->entry_count > (data.size() - header->toc_offset) / sizeof(AssetPackEntry))
+    {
+        log_error("ASSET_PACK", "{} has a broken table of contents", path);
+        m_file.close();
+        return false;
+    }
+
+    std::span<const AssetPackEntry> entries{
+            reinterpret_cast<const AssetPackEntry*>(data.data() + header->toc_offset), header->entry_count};
+    for (const AssetPackEntry& entry: entries)
+    {
+        if (entry.offset > data.size() || entry.size > data.size() - entry.offset ||
+            entry.name[asset_pack_name_size - 1] != '\0')
+        {
+            log_error("ASSET_PACK", "{} has a broken entry", path);
+            m_file.close();
+            return false;
+        }
+    }
+    m_entries = entries;
+    return true;
+}
+
+std::span<const std::byte> AssetPack::get(std::string_view name) const
+{
+    auto it = std::lower_bound(m_entries.begin(), m_entries.end(), name,
+                               [](const AssetPackEntry& entry, std::string_view key)
+                               {
+                                   return get_entry_name(entry) < key;
+                               });
+    if (it == m_entries.end() || get_entry_name(*it) != name)
+    {
+        log_error("ASSET_PACK", "no asset named {}", name);
+        return {};
+    }
+    return m_file.get_data().subspan(it->offset, it->size);
+}
+
+std::string_view AssetPack::get_text(std::string_view name) const
+{
+    std::span<const std::byte> data = get(name);
+    return {reinterpret_cast<const char*>(data.data()), data.size()};
+}
+
+std::span<const AssetPackEntry> AssetPack::get_entries() const
+{
+    return m_entries;
+}
+
+std::string_view get_entry_name(const AssetPackEntry& entry)
+{
+    return {entry.name, strnlen(entry.name, asset_pack_name_size)};
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+
+#include "MappedFile/MappedFile.h"
+
+/*
+ * Single file holding every asset the game loads (fonts, shaders, later textures).
+ *
+ *   AssetPackHeader
+ *   AssetPackEntry[entry_count]   table of contents, sorted by name
+ *   blobs                         each starting on asset_pack_alignment
+ *
+ * The file is memory mapped and assets are handed out as views into the
+ * mapping, nothing is read() or copied. Packs are written by gl_jump_pack.
+ */
+constexpr char asset_pack_magic[8] = {'G', 'L', 'J', 'P', 'A', 'C', 'K', '\0'};
+constexpr std::uint32_t asset_pack_version = 1;
+constexpr std::size_t asset_pack_alignment = 64;
+constexpr std::size_t asset_pack_name_size = 48;
+
+enum class AssetType : std::uint32_t
+{
+    RAW, FONT, SHADER, TEXTURE
+};
+
+struct AssetPackHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t entry_count;
+    std::uint64_t toc_offset;
+    std::uint64_t file_size;
+};
+
+struct AssetPackEntry
+{
+    char name[asset_pack_name_size]; // NUL padded, e.g. "shaders/shape.vert"
+    AssetType type;
+    std::uint32_t reserved;
+    std::uint64_t offset;
+    std::uint64_t size;
+};
+
+class AssetPack
+{
+public:
+    AssetPack() = default;
+
+    ~AssetPack() = default;
+
+    bool open(const std::string& path);
+
+    // empty span if the pack has no asset with that name
+    std::span<const std::byte> get(std::string_view name) const;
+
+    // shader sources and other text assets, not NUL terminated
+    std::string_view get_text(std::string_view name) const;
+
+    std::span<const AssetPackEntry> get_entries() const;
+
+private:
+    MappedFile m_file;
+    std::span<const AssetPackEntry> m_entries;
+};
+
+std::string_view get_entry_name(const AssetPackEntry& entry);
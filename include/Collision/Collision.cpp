@@ -0,0 +1,20 @@
+#include "Collision.h"
+
+bool check_collision_x(int rectangle_front, int rectangle_back,
+                       int triangle_front, int triangle_back)
+{
+    if (rectangle_front >= triangle_front && rectangle_back <= triangle_back)
+    {
+        return true;
+    }
+    return false;
+}
+
+bool check_collision_y(int rectangle_bottom, int triangle_height)
+{
+    if (rectangle_bottom <= 100 + triangle_height * 7 / 10)
+    {
+        return true;
+    }
+    return false;
+}
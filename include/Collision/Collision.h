@@ -0,0 +1,7 @@
+#pragma once
+
+bool check_collision_x(int rectangle_front, int rectangle_back,
+                       int triangle_front, int triangle_back);
+
+// the triangle stands on the line at y 100, anything below 70% of its height touches it
+bool check_collision_y(int rectangle_bottom, int triangle_height = 50);
@@ -0,0 +1,60 @@
+#pragma once
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <string_view>
+#include <system_error>
+
+/*
+ * Text built into a fixed size buffer, for HUD strings that change every frame.
+ * Numbers are formatted with std::to_chars, nothing touches the heap.
+ * Anything that doesn't fit is cut off.
+ */
+template<std::size_t N>
+class FixedText
+{
+public:
+    FixedText& append(std::string_view text)
+    {
+        std::size_t count = text.size() < N - m_size ? text.size() : N - m_size;
+        text.copy(m_buffer.data() + m_size, count);
+        m_size += count;
+        return *this;
+    }
+
+    FixedText& append(int value)
+    {
+        auto result = std::to_chars(m_buffer.data() + m_size, m_buffer.data() + N, value);
+        if (result.ec == std::errc())
+        {
+            m_size = result.ptr - m_buffer.data();
+        }
+        return *this;
+    }
+
+    FixedText& append(double value, int precision)
+    {
+        auto result = std::to_chars(m_buffer.data() + m_size, m_buffer.data() + N, value,
+                                    std::chars_format::fixed, precision);
+        if (result.ec == std::errc())
+        {
+            m_size = result.ptr - m_buffer.data();
+        }
+        return *this;
+    }
+
+    void clear()
+    {
+        m_size = 0;
+    }
+
+    std::string_view view() const
+    {
+        return {m_buffer.data(), m_size};
+    }
+
+private:
+    std::array<char, N> m_buffer{};
+    std::size_t m_size = 0;
+};
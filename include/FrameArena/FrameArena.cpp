@@ -0,0 +1,47 @@
+#include "FrameArena.h"
+
+#include "Logger/Logger.h"
+
+FrameArena::FrameArena(std::size_t capacity)
+        : m_buffer(std::make_unique<std::byte[]>(capacity)),
+          m_capacity(capacity)
+{
+
+}
+
+void FrameArena::reset()
+{
+    m_offset = 0;
+}
+
+std::size_t FrameArena::get_capacity() const
+{
+    return m_capacity;
+}
+
+std::size_t FrameArena::get_high_water_mark() const
+{
+    return m_high_water_mark;
+}
+
+void* FrameArena::allocate_bytes(std::size_t size, std::size_t alignment)
+{
+    std::size_t begin = (m_offset + alignment - 1) & ~(alignment - 1);
+    if (begin + size > m_capacity)
+    {
+        log_error("FRAME_ARENA", "out of space, {} bytes requested", size);
+        return nullptr;
+    }
+    m_offset = begin + size;
+    if (m_offset > m_high_water_mark)
+    {
+        m_high_water_mark = m_offset;
+    }
+    return m_buffer.get() + begin;
+}
+
+FrameArena& get_frame_arena()
+{
+    static FrameArena arena(1 << 20);
+    return arena;
+}
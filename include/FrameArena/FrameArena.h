@@ -0,0 +1,54 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <span>
+
+/*
+ * Bump allocator for data that only lives until the end of the frame.
+ * The buffer is allocated once; allocate() just moves an offset and
+ * reset() at the start of every frame makes the whole buffer reusable.
+ * Only trivially destructible types belong in here, nothing is destroyed.
+ */
+class FrameArena
+{
+public:
+    explicit FrameArena(std::size_t capacity);
+
+    ~FrameArena() = default;
+
+    FrameArena(const FrameArena&) = delete;
+
+    FrameArena& operator=(const FrameArena&) = delete;
+
+    // returns an empty span when the arena is out of space
+    template<typename T>
+    std::span<T> allocate(std::size_t count)
+    {
+        void* memory = allocate_bytes(count * sizeof(T), alignof(T));
+        if (!memory)
+        {
+            return {};
+        }
+        return {std::launder(static_cast<T*>(memory)), count};
+    }
+
+    void reset();
+
+    std::size_t get_capacity() const;
+
+    // most bytes in use at once since construction, to size the arena
+    std::size_t get_high_water_mark() const;
+
+private:
+    void* allocate_bytes(std::size_t size, std::size_t alignment);
+
+    std::unique_ptr<std::byte[]> m_buffer;
+    std::size_t m_capacity;
+    std::size_t m_offset = 0;
+    std::size_t m_high_water_mark = 0;
+};
+
+// arena shared by everything drawn on the main thread, reset once per frame
+FrameArena& get_frame_arena();
@@ -0,0 +1,182 @@
+#include "FrameEncoder.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+FrameEncoder::FrameEncoder(unsigned int width, unsigned int height, unsigned int frame_rate,
+                           std::size_t slot_count)
+        : m_width(width),
+          m_height(height),
+          m_frame_rate(frame_rate),
+          m_slots(std::max<std::size_t>(slot_count, 1), std::vector<std::uint8_t>(std::size_t(width) * height * 4)),
+          m_yuv(std::size_t(width) * height + 2 * std::size_t((width + 1) / 2) * ((height + 1) / 2))
+{
+
+}
+
+FrameEncoder::~FrameEncoder()
+{
+    close();
+}
+
+bool FrameEncoder::open(const std::string& path)
+{
+    close();
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file)
+    {
+        log_error("CAPTURE", "Failed to open {}", path);
+        return false;
+    }
+    m_y4m = path.size() >= 4 && path.compare(path.size() - 4, 4, ".y4m") == 0;
+    if (m_y4m)
+    {
+        m_file << "YUV4MPEG2 W" << m_width << " H" << m_height << " F" << m_frame_rate << ":1 Ip A1:1 C420jpeg\n";
+    }
+    m_stop = false;
+    m_frames_written = 0;
+    m_producer_waits = 0;
+    m_convert_ms = 0.0;
+    m_worker = std::thread(&FrameEncoder::worker_loop, this);
+    return true;
+}
+
+std::span<std::uint8_t> FrameEncoder::acquire_frame()
+{
+    std::unique_lock lock(m_mutex);
+    if (m_queued == m_slots.size())
+    {
+        m_producer_waits++;
+        m_slot_freed.wait(lock, [this]
+        { return m_queued < m_slots.size(); });
+    }
+    return m_slots[m_write_slot];
+}
+
+void FrameEncoder::submit_frame()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_write_slot = (m_write_slot + 1) % m_slots.size();
+        m_queued++;
+    }
+    m_frame_queued.notify_one();
+}
+
+void FrameEncoder::close()
+{
+    if (!m_worker.joinable())
+    {
+        return;
+    }
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_frame_queued.notify_one();
+    m_worker.join();
+    m_file.close();
+}
+
+std::uint64_t FrameEncoder::get_frames_written() const
+{
+    std::lock_guard lock(m_mutex);
+    return m_frames_written;
+}
+
+void FrameEncoder::print_report() const
+{
+    std::lock_guard lock(m_mutex);
+    std::cout << "capture: " << m_frames_written << " frames written, "
+              << (m_frames_written ? m_convert_ms / static_cast<double>(m_frames_written) : 0.0)
+              << " ms per frame to convert and write, waited for the writer " << m_producer_waits << " times"
+              << std::endl;
+}
+
+void FrameEncoder::worker_loop()
+{
+    while (true)
+    {
+        std::size_t slot;
+        {
+            std::unique_lock lock(m_mutex);
+            m_frame_queued.wait(lock, [this]
+            { return m_queued > 0 || m_stop; });
+            // queued frames are still written after close()
+            if (m_queued == 0)
+            {
+                return;
+            }
+            slot = m_read_slot;
+        }
+
+        auto begin = std::chrono::steady_clock::now();
+        convert(m_slots[slot]);
+        if (m_y4m)
+        {
+            m_file.write("FRAME\n", 6);
+        }
+        m_file.write(reinterpret_cast<const char*>(m_yuv.data()), static_cast<std::streamsize>(m_yuv.size()));
+        double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+
+        {
+            std::lock_guard lock(m_mutex);
+            m_read_slot = (m_read_slot + 1) % m_slots.size();
+            m_queued--;
+            m_frames_written++;
+            m_convert_ms += ms;
+        }
+        m_slot_freed.notify_one();
+    }
+}
+
+void FrameEncoder::convert(std::span<const std::uint8_t> rgba)
+{
+    // BT.601 studio range in 8 bit fixed point, chroma averaged over each 2x2 block
+    std::size_t chroma_width = (m_width + 1) / 2;
+    std::size_t chroma_height = (m_height + 1) / 2;
+    std::uint8_t* y_plane = m_yuv.data();
+    std::uint8_t* u_plane = y_plane + std::size_t(m_width) * m_height;
+    std::uint8_t* v_plane = u_plane + chroma_width * chroma_height;
+
+    auto pixel = [&](std::size_t x, std::size_t y)
+    {
+        // glReadPixels rows go bottom up
+        return rgba.data() + ((m_height - 1 - y) * std::size_t(m_width) + x) * 4;
+    };
+
+    for (std::size_t y = 0; y < m_height; y++)
+    {
+        std::uint8_t* y_row = y_plane + y * m_width;
+        for (std::size_t x = 0; x < m_width; x++)
+        {
+            const std::uint8_t* p = pixel(x, y);
+            y_row[x] = static_cast<std::uint8_t>(16 + ((66 * p[0] + 129 * p[1] + 25 * p[2] + 128) >> 8));
+        }
+    }
+    for (std::size_t cy = 0; cy < chroma_height; cy++)
+    {
+        for (std::size_t cx = 0; cx < chroma_width; cx++)
+        {
+            int r = 0;
+            int g = 0;
+            int b = 0;
+            for (std::size_t i = 0; i < 4; i++)
+            {
+                const std::uint8_t* p = pixel(std::min<std::size_t>(cx * 2 + (i & 1), m_width - 1),
+                                              std::min<std::size_t>(cy * 2 + (i >> 1), m_height - 1));
+                r += p[0];
+                g += p[1];
+                b += p[2];
+            }
+            r /= 4;
+            g /= 4;
+            b /= 4;
+            u_plane[cy * chroma_width + cx] = static_cast<std::uint8_t>(128 + ((-38 * r - 74 * g + 112 * b + 128) >> 8));
+            v_plane[cy * chroma_width + cx] = static_cast<std::uint8_t>(128 + ((112 * r - 94 * g - 18 * b + 128) >> 8));
+        }
+    }
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <mutex>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+/*
+ * Writes captured frames as a Y4M video, or as raw I420 frames when the
+ * path doesn't end in .y4m. Frames come in as RGBA rows bottom first, the
+ * way glReadPixels leaves them, and a worker thread converts them to
+ * BT.601 4:2:0 and writes them out. Hand over goes through a fixed ring of
+ * frame slots, so nothing is allocated once the file is open; when the
+ * worker falls behind by the whole ring, acquire_frame waits for it.
+ */
+class FrameEncoder
+{
+public:
+    FrameEncoder(unsigned int width, unsigned int height, unsigned int frame_rate, std::size_t slot_count = 4);
+
+    // writes whatever is still queued
+    ~FrameEncoder();
+
+    FrameEncoder(const FrameEncoder&) = delete;
+
+    FrameEncoder& operator=(const FrameEncoder&) = delete;
+
+    bool open(const std::string& path);
+
+    // width * height * 4 bytes for the next frame, valid until submit_frame
+    std::span<std::uint8_t> acquire_frame();
+
+    void submit_frame();
+
+    // waits until every submitted frame is written and closes the file
+    void close();
+
+    std::uint64_t get_frames_written() const;
+
+    void print_report() const;
+
+private:
+    void worker_loop();
+
+    void convert(std::span<const std::uint8_t> rgba);
+
+    unsigned int m_width;
+    unsigned int m_height;
+    unsigned int m_frame_rate;
+    bool m_y4m = true;
+    std::ofstream m_file;
+
+    std::vector<std::vector<std::uint8_t>> m_slots;
+    std::vector<std::uint8_t> m_yuv;
+    // slots are filled at m_write_slot and drained at m_read_slot, m_queued apart
+    std::size_t m_write_slot = 0;
+    std::size_t m_read_slot = 0;
+    std::size_t m_queued = 0;
+    bool m_stop = false;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_frame_queued;
+    std::condition_variable m_slot_freed;
+    std::thread m_worker;
+
+    std::uint64_t m_frames_written = 0;
+    std::uint64_t m_producer_waits = 0;
+    double m_convert_ms = 0.0;
+};
@@ -0,0 +1,78 @@
+#include "FrameStats.h"
+
+#include <algorithm>
+
+void FrameStats::record(const frame_sample& sample)
+{
+    std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    m_slot& slot = m_slots[head % capacity];
+    slot.frame_ms.store(sample.frame_ms, std::memory_order_relaxed);
+    slot.sim_ms.store(sample.sim_ms, std::memory_order_relaxed);
+    slot.draw_calls.store(sample.draw_calls, std::memory_order_relaxed);
+    slot.gl_objects.store(sample.gl_objects, std::memory_order_relaxed);
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+std::size_t FrameStats::read_recent(std::span<frame_sample> out) const
+{
+    std::uint64_t head = m_head.load(std::memory_order_acquire);
+    std::uint64_t count = std::min<std::uint64_t>({out.size(), head, capacity});
+    std::uint64_t first = head - count;
+    for (std::uint64_t i = 0; i < count; i++)
+    {
+        const m_slot& slot = m_slots[(first + i) % capacity];
+        out[i] = {slot.frame_ms.load(std::memory_order_relaxed), slot.sim_ms.load(std::memory_order_relaxed),
+                  slot.draw_calls.load(std::memory_order_relaxed), slot.gl_objects.load(std::memory_order_relaxed)};
+    }
+
+    // the writer may have lapped us, the slot it is filling now counts as rewritten too
+    std::uint64_t new_head = m_head.load(std::memory_order_acquire);
+    std::uint64_t first_valid = new_head + 1 > capacity ? new_head + 1 - capacity : 0;
+    if (first_valid > first)
+    {
+        std::uint64_t dropped = std::min(first_valid - first, count);
+        std::copy(out.begin() + dropped, out.begin() + count, out.begin());
+        count -= dropped;
+    }
+    return count;
+}
+
+frame_summary FrameStats::summarize(std::size_t window) const
+{
+    std::array<frame_sample, capacity> samples;
+    std::size_t count = read_recent({samples.data(), std::min(window, capacity)});
+    frame_summary summary;
+    summary.samples = count;
+    if (count == 0)
+    {
+        return summary;
+    }
+
+    std::array<float, capacity> frame_times;
+    float total_ms = 0.0f;
+    float total_sim_ms = 0.0f;
+    for (std::size_t i = 0; i < count; i++)
+    {
+        frame_times[i] = samples[i].frame_ms;
+        total_ms += samples[i].frame_ms;
+        total_sim_ms += samples[i].sim_ms;
+    }
+
+    // nth_element leaves everything above each rank behind it, so later ranks search a shrinking tail
+    auto percentile = [&](std::size_t begin, float fraction)
+    {
+        std::size_t rank = std::min(static_cast<std::size_t>(fraction * count), count - 1);
+        std::nth_element(frame_times.begin() + begin, frame_times.begin() + rank, frame_times.begin() + count);
+        return rank;
+    };
+    std::size_t p50 = percentile(0, 0.50f);
+    std::size_t p95 = percentile(p50, 0.95f);
+    std::size_t p99 = percentile(p95, 0.99f);
+    summary.p50_ms = frame_times[p50];
+    summary.p95_ms = frame_times[p95];
+    summary.p99_ms = frame_times[p99];
+    summary.max_ms = *std::max_element(frame_times.begin() + p99, frame_times.begin() + count);
+    summary.fps = total_ms > 0.0f ? 1000.0f * count / total_ms : 0.0f;
+    summary.sim_ms = total_sim_ms / count;
+    return summary;
+}
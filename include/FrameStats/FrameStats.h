@@ -0,0 +1,58 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+struct frame_sample
+{
+    float frame_ms = 0.0f;
+    float sim_ms = 0.0f;
+    std::uint32_t draw_calls = 0;
+    std::uint32_t gl_objects = 0;
+};
+
+struct frame_summary
+{
+    std::size_t samples = 0;
+    float fps = 0.0f;
+    float p50_ms = 0.0f;
+    float p95_ms = 0.0f;
+    float p99_ms = 0.0f;
+    float max_ms = 0.0f;
+    float sim_ms = 0.0f;
+};
+
+/*
+ * The last frame_stats_capacity frames in a fixed ring. One thread records,
+ * any thread may read: every field is a relaxed atomic and the head is
+ * published with release, so readers never block the game loop. A reader
+ * that gets lapped while copying throws away the slots that were rewritten.
+ */
+class FrameStats
+{
+public:
+    static constexpr std::size_t capacity = 256;
+
+    void record(const frame_sample& sample);
+
+    // copies up to out.size() of the newest samples, oldest first, returns how many
+    std::size_t read_recent(std::span<frame_sample> out) const;
+
+    // percentiles of frame time and mean sim time over the newest window samples
+    frame_summary summarize(std::size_t window) const;
+
+private:
+    struct m_slot
+    {
+        std::atomic<float> frame_ms{0.0f};
+        std::atomic<float> sim_ms{0.0f};
+        std::atomic<std::uint32_t> draw_calls{0};
+        std::atomic<std::uint32_t> gl_objects{0};
+    };
+
+    std::array<m_slot, capacity> m_slots;
+    std::atomic<std::uint64_t> m_head{0};
+};
@@ -0,0 +1,212 @@
+#include "GameState.h"
+
+#include "Collision/Collision.h"
+
+namespace
+{
+    // tick on which a triangle spawned at the current score gets to target_score
+    std::uint32_t tick_of_score(const GameState& state, int target_score)
+    {
+        return state.timers.get_now() + static_cast<std::uint32_t>(target_score - state.score);
+    }
+
+    // in a game, also schedules when it reaches the square, leaves it behind and goes past its span's spacing
+    void spawn_obstacle(GameState& state, const Level& level, int pos_x, bool schedule)
+    {
+        Triangle& triangle = state.triangle;
+        const Rectangle& rectangle = state.rectangle;
+        triangle.spawn(pos_x, state.score);
+        state.obstacle_in_reach = false;
+        if (!schedule)
+        {
+            return;
+        }
+        state.timers.schedule(
+                tick_of_score(state, triangle.score_left_of(rectangle.rectangle_pos_x + rectangle.rectangle_width + 1)),
+                game_timer::OBSTACLE_NEAR);
+        state.timers.schedule(
+                tick_of_score(state, triangle.score_left_of(rectangle.rectangle_pos_x - triangle.triangle_width)),
+                game_timer::OBSTACLE_PAST);
+        state.timers.schedule(tick_of_score(state, triangle.score_left_of(
+                -level.get_span(LevelTrack::OBSTACLES, state.obstacle_pass).spacing)), game_timer::OBSTACLE_DESPAWN);
+    }
+
+    void spawn_background(GameState& state, const Level& level, int pos_x, bool schedule)
+    {
+        state.bg_triangle.spawn(pos_x, state.score);
+        if (!schedule)
+        {
+            return;
+        }
+        state.timers.schedule(tick_of_score(state, state.bg_triangle.score_left_of(
+                -level.get_span(LevelTrack::DECORATIONS, state.background_pass).spacing)),
+                              game_timer::BACKGROUND_DESPAWN);
+    }
+}
+
+GameState make_game_state(const Level& level, unsigned int screen_width, std::uint32_t obstacle_pass,
+                          std::uint32_t background_pass)
+{
+    GameState state;
+    state.obstacle_pass = obstacle_pass % level.get_span_count(LevelTrack::OBSTACLES);
+    state.background_pass = background_pass % level.get_span_count(LevelTrack::DECORATIONS);
+    const LevelSpan& obstacle = level.get_span(LevelTrack::OBSTACLES, state.obstacle_pass);
+    state.triangle.triangle_width = obstacle.width;
+    state.triangle.triangle_height = obstacle.height;
+    spawn_obstacle(state, level, static_cast<int>(screen_width), false);
+    const LevelSpan& decoration = level.get_span(LevelTrack::DECORATIONS, state.background_pass);
+    state.bg_triangle.triangle_width = decoration.width;
+    state.bg_triangle.triangle_height = decoration.height;
+    spawn_background(state, level, static_cast<int>(screen_width) + 550, false);
+    return state;
+}
+
+game_events step_game(GameState& state, bool space_pressed, const Level& level, unsigned int screen_width)
+{
+    game_events events;
+    Rectangle& rectangle = state.rectangle;
+    Triangle& triangle = state.triangle;
+    Triangle& bg_triangle = state.bg_triangle;
+
+    // the wheel moves on to the tick this step ends on, the GAME rules below handle what came due
+    std::uint32_t due = 0;
+    state.timers.advance([&](std::span<const game_timer> batch)
+                         {
+                             for (game_timer timer: batch)
+                             {
+                                 due |= 1u << static_cast<unsigned int>(timer);
+                             }
+                         });
+    auto is_due = [&](game_timer timer)
+    {
+        return (due & (1u << static_cast<unsigned int>(timer))) != 0;
+    };
+
+    switch (state.current_game_state)
+    {
+        case GAME_STATE::START:
+            // don't allow game to restart
+            // if player was previously holding space
+            if (space_pressed && !state.prev_space)
+            {
+                rectangle.jump_state = true;
+            }
+            if (rectangle.jump_state)
+            {
+                rectangle.jump();
+                if (rectangle.rectangle_pos_y <= 100)
+                {
+                    state.current_game_state = GAME_STATE::GAME;
+                    state.score = 0;
+                    events.started = true;
+                    // the first tick of the game is the one this step ends on
+                    state.run_start_tick = state.tick + 1;
+                    // the obstacles waited at the right edge, their motion starts over with the score
+                    spawn_obstacle(state, level, triangle.triangle_pos_x, true);
+                    spawn_background(state, level, bg_triangle.triangle_pos_x, true);
+                }
+            }
+            break;
+        case GAME_STATE::GAME:
+            state.score += 1;
+            // allow the player to hold space by not checking prev state
+            if (space_pressed)
+            {
+                rectangle.jump_state = true;
+            }
+            if (rectangle.jump_state)
+            {
+                rectangle.jump();
+                events.landed = !rectangle.jump_state;
+            }
+
+            // each span travels its spacing past the left edge, then the next one comes in
+            if (is_due(game_timer::OBSTACLE_DESPAWN))
+            {
+                state.obstacle_pass = (state.obstacle_pass + 1) % level.get_span_count(LevelTrack::OBSTACLES);
+                const LevelSpan& obstacle = level.get_span(LevelTrack::OBSTACLES, state.obstacle_pass);
+                triangle.triangle_width = obstacle.width;
+                triangle.triangle_height = obstacle.height;
+                spawn_obstacle(state, level, static_cast<int>(screen_width), true);
+            }
+            if (is_due(game_timer::BACKGROUND_DESPAWN))
+            {
+                state.background_pass = (state.background_pass + 1) % level.get_span_count(LevelTrack::DECORATIONS);
+                const LevelSpan& decoration = level.get_span(LevelTrack::DECORATIONS, state.background_pass);
+                bg_triangle.triangle_width = decoration.width;
+                bg_triangle.triangle_height = decoration.height;
+                spawn_background(state, level, static_cast<int>(screen_width), true);
+            }
+            if (is_due(game_timer::OBSTACLE_NEAR))
+            {
+                state.obstacle_in_reach = true;
+            }
+            if (is_due(game_timer::OBSTACLE_PAST))
+            {
+                state.obstacle_in_reach = false;
+            }
+
+            // the obstacle's x is only needed while it can touch the square
+            if (state.obstacle_in_reach)
+            {
+                int obstacle_x = triangle.position_at(state.score);
+                if (check_collision_x(rectangle.rectangle_pos_x + rectangle.rectangle_width,
+                                      rectangle.rectangle_pos_x, obstacle_x, obstacle_x + triangle.triangle_width)
+                    && check_collision_y(rectangle.rectangle_pos_y, triangle.triangle_height))
+                {
+                    events.collided = true;
+                }
+            }
+            if (events.collided)
+            {
+                rectangle.jump_state = false;
+                // nothing moves on the title screen, the next start schedules again
+                state.timers.clear();
+                spawn_background(state, level, static_cast<int>(screen_width) + 550, false);
+                spawn_obstacle(state, level, static_cast<int>(screen_width), false);
+                state.current_game_state = GAME_STATE::START;
+            }
+            break;
+    }
+    state.prev_space = space_pressed;
+    state.tick++;
+    return events;
+}
+
+std::uint64_t hash_game_state(const GameState& state)
+{
+    // FNV-1a over the fields, not the bytes, padding isn't guaranteed to match
+    std::uint64_t hash = 0xCBF29CE484222325ull;
+    auto mix = [&](std::int64_t value)
+    {
+        hash = (hash ^ static_cast<std::uint64_t>(value)) * 0x100000001B3ull;
+    };
+    const Rectangle& rectangle = state.rectangle;
+    for (int value: {rectangle.rectangle_width, rectangle.rectangle_height, rectangle.rectangle_pos_x,
+                     rectangle.rectangle_pos_y, static_cast<int>(rectangle.jump_state), rectangle.jump_amount})
+    {
+        mix(value);
+    }
+    for (const Triangle* triangle: {&state.triangle, &state.bg_triangle})
+    {
+        for (int value: {triangle->triangle_width, triangle->triangle_height, triangle->triangle_pos_x,
+                         triangle->triangle_pos_y, triangle->spawn_score})
+        {
+            mix(value);
+        }
+    }
+    for (std::int64_t value: {std::int64_t(state.score), std::int64_t(state.current_game_state),
+                              std::int64_t(state.prev_space), std::int64_t(state.obstacle_pass),
+                              std::int64_t(state.background_pass), std::int64_t(state.tick),
+                              std::int64_t(state.run_start_tick), std::int64_t(state.obstacle_in_reach),
+                              std::int64_t(state.timers.get_now())})
+    {
+        mix(value);
+    }
+    state.timers.for_each_pending([&](std::uint32_t deadline, game_timer timer)
+                                  {
+                                      mix(deadline);
+                                      mix(static_cast<std::int64_t>(timer));
+                                  });
+    return hash;
+}
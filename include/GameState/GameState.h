@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstdint>
+#include <type_traits>
+
+#include "Rectangle/Rectangle.h"
+#include "Triangle/Triangle.h"
+#include "Level/Level.h"
+#include "TimingWheel/TimingWheel.h"
+
+enum GAME_STATE
+{
+    START, GAME, END
+};
+
+// the simulation always advances in steps of this size, whatever the frame rate
+constexpr double game_tick_seconds = 1.0 / 60.0;
+
+// what a GameState schedules on its wheel
+enum class game_timer : std::uint8_t
+{
+    // the obstacle can touch the square from OBSTACLE_NEAR until OBSTACLE_PAST
+    OBSTACLE_NEAR, OBSTACLE_PAST, OBSTACLE_DESPAWN, BACKGROUND_DESPAWN
+};
+
+// one of each game_timer pending at most, three levels of 8 slots reach 4096 ticks out
+using game_timers = TimingWheel<game_timer, 4, 3, 4>;
+
+/*
+ * Everything one player's game needs between ticks. The obstacle course
+ * itself lives in a shared Level, the state only keeps its place in it, and
+ * what happens later sits on a small timing wheel driven by the tick, so a
+ * snapshot is a plain copy of under 256 bytes.
+ */
+struct GameState
+{
+    Rectangle rectangle{60, 60, 100, 100};
+    Triangle triangle{50, 50, 0, 100};
+    Triangle bg_triangle{0, 0, 0, 100};
+    int score = 0;
+    int current_game_state = GAME_STATE::START;
+    // space on the previous tick, starting a game needs a fresh press
+    bool prev_space = false;
+    std::uint32_t obstacle_pass = 0;
+    std::uint32_t background_pass = 0;
+    std::uint32_t tick = 0;
+    // tick the current or last game started on, a rewind takes it back with the rest
+    std::uint32_t run_start_tick = 0;
+    // between OBSTACLE_NEAR and OBSTACLE_PAST
+    bool obstacle_in_reach = false;
+    // scheduled when the triangles spawn in a game, on the ticks their
+    // positions get there. the wheel's tick is always this state's tick
+    game_timers timers;
+};
+
+static_assert(std::is_trivially_copyable_v<GameState>);
+
+// what happened during a tick, for effects that aren't part of the state
+struct game_events
+{
+    bool started = false;
+    bool landed = false;
+    bool collided = false;
+};
+
+// on the title screen, the course starting at the given spans of each track
+GameState make_game_state(const Level& level, unsigned int screen_width, std::uint32_t obstacle_pass = 0,
+                          std::uint32_t background_pass = 0);
+
+// one fixed tick of the START/GAME rules, deterministic for the same state and input
+game_events step_game(GameState& state, bool space_pressed, const Level& level, unsigned int screen_width);
+
+// hash of every field, to compare the states of two machines
+std::uint64_t hash_game_state(const GameState& state);
@@ -0,0 +1,165 @@
+#include "GhostSystem.h"
+
+#include <algorithm>
+
+#include "Rectangle/Rectangle.h"
+
+namespace
+{
+    // ghost ticks per chunk, below this handing work to the workers costs more than it saves
+    constexpr std::size_t min_ticks_per_chunk = 16384;
+}
+
+InputLog::InputLog(std::uint32_t max_ticks)
+        : m_max_ticks(max_ticks),
+          m_words(new std::uint64_t[(max_ticks + 63) / 64]())
+{
+
+}
+
+void InputLog::push(bool space_pressed)
+{
+    if (m_tick_count == m_max_ticks)
+    {
+        return;
+    }
+    std::uint64_t& word = m_words[m_tick_count / 64];
+    std::uint64_t bit = std::uint64_t(1) << (m_tick_count % 64);
+    word = space_pressed ? word | bit : word & ~bit;
+    m_tick_count++;
+}
+
+void InputLog::truncate(std::uint32_t tick_count)
+{
+    m_tick_count = std::min(m_tick_count, tick_count);
+}
+
+void InputLog::clear()
+{
+    m_tick_count = 0;
+}
+
+std::span<const std::uint64_t> InputLog::get_words() const
+{
+    return {m_words.get(), (m_tick_count + 63) / 64};
+}
+
+std::uint32_t InputLog::get_tick_count() const
+{
+    return m_tick_count;
+}
+
+GhostSystem::GhostSystem(std::size_t capacity, unsigned int thread_count)
+        : m_capacity(capacity),
+          m_pos_y(new int[capacity]),
+          m_jump_amount(new int[capacity]),
+          m_jump_state(new bool[capacity]),
+          m_input_offset(new std::uint32_t[capacity]),
+          m_input_ticks(new std::uint32_t[capacity]),
+          m_pool(thread_count)
+{
+
+}
+
+bool GhostSystem::add(std::span<const std::uint64_t> inputs, std::uint32_t tick_count)
+{
+    if (m_count == m_capacity || inputs.size() * 64 < tick_count)
+    {
+        return false;
+    }
+    m_input_offset[m_count] = static_cast<std::uint32_t>(m_inputs.size());
+    m_input_ticks[m_count] = tick_count;
+    m_inputs.insert(m_inputs.end(), inputs.begin(), inputs.end());
+    m_count++;
+    // the new ghost starts from the beginning of its run like the others
+    reset_ghosts();
+    return true;
+}
+
+void GhostSystem::seek(std::uint32_t tick)
+{
+    if (tick < m_tick)
+    {
+        reset_ghosts();
+    }
+    if (tick == m_tick || m_count == 0)
+    {
+        m_tick = tick;
+        return;
+    }
+
+    std::uint32_t from = m_tick;
+    std::size_t steps = tick - from;
+    std::size_t grain = std::max<std::size_t>(min_ticks_per_chunk / steps, 64);
+    m_pool.parallel_for(m_count, grain, [&](std::size_t begin, std::size_t end)
+    {
+        const std::uint64_t* inputs = m_inputs.data();
+        for (std::size_t i = begin; i < end; i++)
+        {
+            const std::uint64_t* log = inputs + m_input_offset[i];
+            std::uint32_t last = std::min(tick, m_input_ticks[i]);
+            int pos_y = m_pos_y[i];
+            int jump_amount = m_jump_amount[i];
+            bool jump_state = m_jump_state[i];
+            // the GAME rules for the square, holding space keeps jumping
+            for (std::uint32_t t = from; t < last; t++)
+            {
+                if ((log[t / 64] >> (t % 64)) & 1)
+                {
+                    jump_state = true;
+                }
+                if (jump_state)
+                {
+                    apply_jump(pos_y, jump_amount, jump_state);
+                }
+            }
+            m_pos_y[i] = pos_y;
+            m_jump_amount[i] = jump_amount;
+            m_jump_state[i] = jump_state;
+        }
+    });
+    m_tick = tick;
+}
+
+std::size_t GhostSystem::write_instances(std::span<glm::vec2> corners) const
+{
+    std::size_t written = 0;
+    for (std::size_t i = 0; i < m_count && written < corners.size(); i++)
+    {
+        if (m_tick < m_input_ticks[i])
+        {
+            corners[written++] = {static_cast<float>(m_pos_x), static_cast<float>(m_pos_y[i])};
+        }
+    }
+    return written;
+}
+
+void GhostSystem::clear()
+{
+    m_count = 0;
+    m_tick = 0;
+    m_inputs.clear();
+}
+
+std::size_t GhostSystem::get_count() const
+{
+    return m_count;
+}
+
+std::size_t GhostSystem::get_capacity() const
+{
+    return m_capacity;
+}
+
+std::uint32_t GhostSystem::get_tick() const
+{
+    return m_tick;
+}
+
+void GhostSystem::reset_ghosts()
+{
+    std::fill_n(m_pos_y.get(), m_count, m_start_pos_y);
+    std::fill_n(m_jump_amount.get(), m_count, 10);
+    std::fill_n(m_jump_state.get(), m_count, false);
+    m_tick = 0;
+}
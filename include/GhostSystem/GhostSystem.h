@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "ThreadPool/ThreadPool.h"
+
+/*
+ * The space bit of every GAME tick of one run, 64 ticks to a word.
+ * Fixed capacity, pushing never allocates.
+ */
+class InputLog
+{
+public:
+    explicit InputLog(std::uint32_t max_ticks);
+
+    // stops quietly when full
+    void push(bool space_pressed);
+
+    // forgets every tick from tick_count on
+    void truncate(std::uint32_t tick_count);
+
+    void clear();
+
+    std::span<const std::uint64_t> get_words() const;
+
+    std::uint32_t get_tick_count() const;
+
+private:
+    std::uint32_t m_max_ticks;
+    std::uint32_t m_tick_count = 0;
+    std::unique_ptr<std::uint64_t[]> m_words;
+};
+
+/*
+ * Replays recorded runs as ghosts. A ghost is nothing but an input log and
+ * the vertical state of its square, advanced with the same apply_jump
+ * rules as the player, so it retraces the recorded run exactly. Ghosts
+ * are stored as structure of arrays and stepped in parallel on the pool;
+ * when seek() only moves a tick forward the work is too small to hand
+ * out and runs inline. A ghost disappears once its log runs out, which is
+ * the tick that run ended on.
+ * Only add() allocates.
+ */
+class GhostSystem
+{
+public:
+    GhostSystem(std::size_t capacity, unsigned int thread_count = std::thread::hardware_concurrency());
+
+    // a run starting at GAME start, false when full
+    bool add(std::span<const std::uint64_t> inputs, std::uint32_t tick_count);
+
+    // puts every ghost where its run was after tick ticks, going back replays from the start
+    void seek(std::uint32_t tick);
+
+    // lower left corners of the ghosts still running, returns how many were written
+    std::size_t write_instances(std::span<glm::vec2> corners) const;
+
+    void clear();
+
+    std::size_t get_count() const;
+
+    std::size_t get_capacity() const;
+
+    std::uint32_t get_tick() const;
+
+private:
+    // the player's square where a GAME starts
+    static constexpr int m_pos_x = 100;
+    static constexpr int m_start_pos_y = 100;
+
+    void reset_ghosts();
+
+    std::size_t m_capacity;
+    std::size_t m_count = 0;
+    std::uint32_t m_tick = 0;
+
+    std::unique_ptr<int[]> m_pos_y;
+    std::unique_ptr<int[]> m_jump_amount;
+    std::unique_ptr<bool[]> m_jump_state;
+    // where each ghost's log starts in m_inputs, in words, and how many ticks it holds
+    std::unique_ptr<std::uint32_t[]> m_input_offset;
+    std::unique_ptr<std::uint32_t[]> m_input_ticks;
+    std::vector<std::uint64_t> m_inputs;
+
+    ThreadPool m_pool;
+};
@@ -0,0 +1,123 @@
+#include "JumpEnv.h"
+
+#include <algorithm>
+#include <iostream>
+
+JumpEnv::JumpEnv(std::size_t instance_count, const Level& level, std::uint64_t seed, unsigned int screen_width,
+                 unsigned int thread_count)
+        : m_screen_width(screen_width),
+          m_instances(instance_count),
+          m_pool(thread_count)
+{
+    // enough chunks per thread for stealing to even out the load
+    m_grain = std::max<std::size_t>(256, instance_count / (m_pool.get_thread_count() * 8));
+
+    std::vector<LevelSpan> obstacles(level.get_span_count(LevelTrack::OBSTACLES));
+    std::vector<LevelSpan> decorations(level.get_span_count(LevelTrack::DECORATIONS));
+    for (std::uint32_t i = 0; i < obstacles.size(); i++)
+    {
+        obstacles[i] = level.get_span(LevelTrack::OBSTACLES, i);
+    }
+    for (std::uint32_t i = 0; i < decorations.size(); i++)
+    {
+        decorations[i] = level.get_span(LevelTrack::DECORATIONS, i);
+    }
+    std::vector<std::byte> image = write_level(obstacles, decorations);
+    m_levels.resize((instance_count + m_grain - 1) / m_grain);
+    for (Level& chunk_level: m_levels)
+    {
+        chunk_level.load(image);
+    }
+
+    Random seeder{seed};
+    for (std::size_t i = 0; i < m_instances.size(); i++)
+    {
+        m_instances[i].random.state = seeder.next();
+        reset_instance(m_instances[i], get_level(i));
+    }
+}
+
+void JumpEnv::reset(float* observations)
+{
+    m_pool.parallel_for(m_instances.size(), m_grain, [&](std::size_t begin, std::size_t end)
+    {
+        for (std::size_t i = begin; i < end; i++)
+        {
+            reset_instance(m_instances[i], get_level(i));
+            write_observation(m_instances[i].state, observations + i * observation_size);
+        }
+    });
+}
+
+void JumpEnv::step(const std::uint8_t* actions, float* observations, float* rewards, std::uint8_t* dones)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    m_pool.parallel_for(m_instances.size(), m_grain, [&](std::size_t begin, std::size_t end)
+    {
+        const Level& level = get_level(begin);
+        for (std::size_t i = begin; i < end; i++)
+        {
+            m_instance& instance = m_instances[i];
+            bool collided = step_game(instance.state, actions[i] != 0, level, m_screen_width).collided;
+            if (collided)
+            {
+                reset_instance(instance, level);
+            }
+            rewards[i] = collided ? -1.0f : 1.0f;
+            dones[i] = collided;
+            write_observation(instance.state, observations + i * observation_size);
+        }
+    });
+
+    m_step_time += std::chrono::steady_clock::now() - start;
+    m_total_steps += m_instances.size();
+}
+
+std::size_t JumpEnv::get_instance_count() const
+{
+    return m_instances.size();
+}
+
+double JumpEnv::get_steps_per_second() const
+{
+    double seconds = std::chrono::duration<double>(m_step_time).count();
+    return seconds > 0.0 ? m_total_steps / seconds : 0.0;
+}
+
+void JumpEnv::print_throughput() const
+{
+    std::cout << "JumpEnv: " << m_instances.size() << " instances on "
+              << m_pool.get_thread_count() << " threads, " << m_total_steps << " steps, "
+              << static_cast<std::uint64_t>(get_steps_per_second()) << " steps/s" << std::endl;
+}
+
+const Level& JumpEnv::get_level(std::size_t i) const
+{
+    // parallel_for hands out chunks starting at multiples of the grain
+    return m_levels[i / m_grain];
+}
+
+void JumpEnv::reset_instance(m_instance& instance, const Level& level)
+{
+    instance.state = make_game_state(level, m_screen_width,
+                                     static_cast<std::uint32_t>(instance.random.next()),
+                                     static_cast<std::uint32_t>(instance.random.next()));
+    // a press on the title screen, then the game starts once the square lands
+    bool space = true;
+    while (instance.state.current_game_state != GAME_STATE::GAME)
+    {
+        step_game(instance.state, space, level, m_screen_width);
+        space = false;
+    }
+}
+
+void JumpEnv::write_observation(const GameState& state, float* observation) const
+{
+    observation[0] = state.rectangle.rectangle_pos_y;
+    observation[1] = state.rectangle.jump_state;
+    observation[2] = state.rectangle.jump_amount;
+    observation[3] = state.triangle.position_at(state.score);
+    observation[4] = state.triangle.triangle_width;
+    observation[5] = state.score;
+}
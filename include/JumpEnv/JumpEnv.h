@@ -0,0 +1,75 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "GameState/GameState.h"
+#include "Level/Level.h"
+#include "Random/Random.h"
+#include "ThreadPool/ThreadPool.h"
+
+/*
+ * Headless batch of independent gl_jump games for bots and soak tests.
+ * Every instance is a GameState stepped by step_game, the same rules and
+ * course the game plays, so no window or GL context is needed. Each has
+ * its own seeded generator that picks the spans an episode starts from.
+ * An episode starts in the GAME state, the title screen is skipped.
+ * step() writes into caller owned arrays and never allocates.
+ *
+ * A Level caches what it decodes, so the course is copied into one Level
+ * per chunk of instances; a chunk is only ever stepped by one thread.
+ *
+ * observations: instance_count * observation_size floats, per instance
+ *   rectangle_pos_y, jump_state, jump_amount, triangle x, triangle_width, score
+ * rewards:      instance_count floats, 1 for a survived tick, -1 on collision
+ * dones:        instance_count bytes, 1 when the instance collided this step;
+ *               it is reset right away and its observation is the new episode's first
+ */
+class JumpEnv
+{
+public:
+    static constexpr std::size_t observation_size = 6;
+
+    // level is only read here, on the calling thread
+    JumpEnv(std::size_t instance_count, const Level& level, std::uint64_t seed, unsigned int screen_width,
+            unsigned int thread_count = std::thread::hardware_concurrency());
+
+    ~JumpEnv() = default;
+
+    void reset(float* observations);
+
+    // actions: instance_count bytes, non zero presses space for that instance
+    void step(const std::uint8_t* actions, float* observations, float* rewards, std::uint8_t* dones);
+
+    std::size_t get_instance_count() const;
+
+    // steps per second over every step() call so far
+    double get_steps_per_second() const;
+
+    void print_throughput() const;
+
+private:
+    struct m_instance
+    {
+        GameState state;
+        Random random;
+    };
+
+    // the course of the chunk instance i is in
+    const Level& get_level(std::size_t i) const;
+
+    void reset_instance(m_instance& instance, const Level& level);
+
+    void write_observation(const GameState& state, float* observation) const;
+
+    unsigned int m_screen_width;
+    std::vector<m_instance> m_instances;
+    ThreadPool m_pool;
+    std::size_t m_grain;
+    std::vector<Level> m_levels;
+
+    std::uint64_t m_total_steps = 0;
+    std::chrono::steady_clock::duration m_step_time{};
+};
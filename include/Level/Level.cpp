@@ -0,0 +1,220 @@
+#include "Level.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include "Random/Random.h"
+#include "Logger/Logger.h"
+
+namespace
+{
+    SpanType get_track_type(LevelTrack track)
+    {
+        return track == LevelTrack::OBSTACLES ? SpanType::TRIANGLE : SpanType::DECORATION;
+    }
+
+    std::uint32_t get_chunk_count(std::uint32_t span_count)
+    {
+        return (span_count + level_chunk_spans - 1) / level_chunk_spans;
+    }
+}
+
+bool Level::open(const std::string& path)
+{
+    m_image = {};
+    if (!m_file.open(path))
+    {
+        return false;
+    }
+    m_data = m_file.get_data();
+    if (!validate(path))
+    {
+        m_file.close();
+        return false;
+    }
+    return true;
+}
+
+bool Level::load(std::vector<std::byte> image)
+{
+    m_file.close();
+    m_image = std::move(image);
+    m_data = m_image;
+    if (!validate("generated level"))
+    {
+        m_image = {};
+        return false;
+    }
+    return true;
+}
+
+bool Level::is_open() const
+{
+    return !m_data.empty();
+}
+
+std::uint32_t Level::get_span_count(LevelTrack track) const
+{
+    return m_header.tracks[static_cast<std::size_t>(track)].span_count;
+}
+
+const LevelSpan& Level::get_span(LevelTrack track, std::uint32_t index) const
+{
+    std::uint32_t span_count = get_span_count(track);
+    if (span_count == 0)
+    {
+        static const LevelSpan fallback;
+        return fallback;
+    }
+    index %= span_count;
+    std::uint32_t chunk = index / level_chunk_spans;
+
+    // the scroll position only moves forward, have the next chunk ready before it gets there.
+    // it goes first, wrapping around it may share a slot with this one
+    std::uint32_t chunk_count = get_chunk_count(span_count);
+    decode_chunk(track, (chunk + 1) % chunk_count);
+    std::size_t ahead = m_header.tracks[static_cast<std::size_t>(track)].first_chunk + (chunk + 2) % chunk_count;
+    m_file.advise_will_need(level_file_chunk_offset + ahead * sizeof(LevelFileChunk), sizeof(LevelFileChunk));
+
+    return decode_chunk(track, chunk).spans[index % level_chunk_spans];
+}
+
+std::uint64_t Level::get_decoded_chunks() const
+{
+    return m_decoded_chunks;
+}
+
+bool Level::validate(const std::string& name)
+{
+    m_header = {};
+    for (auto& slots: m_cache)
+    {
+        for (m_cached_chunk& slot: slots)
+        {
+            slot.chunk = UINT32_MAX;
+        }
+    }
+
+    if (m_data.size() < level_file_chunk_offset)
+    {
+        log_error("LEVEL", "{} is too small", name);
+        m_data = {};
+        return false;
+    }
+    LevelFileHeader header;
+    std::memcpy(&header, m_data.data(), sizeof(header));
+    if (std::memcmp(header.magic, level_file_magic, sizeof(level_file_magic)) != 0 ||
+        header.version != level_file_version || header.chunk_spans != level_chunk_spans ||
+        header.file_size != m_data.size())
+    {
+        log_error("LEVEL", "{} is not a version {} level", name, level_file_version);
+        m_data = {};
+        return false;
+    }
+    std::size_t chunks_in_file = (m_data.size() - level_file_chunk_offset) / sizeof(LevelFileChunk);
+    for (const LevelFileTrack& track: header.tracks)
+    {
+        if (track.span_count == 0 ||
+            track.first_chunk + std::size_t(get_chunk_count(track.span_count)) > chunks_in_file)
+        {
+            log_error("LEVEL", "{} has a broken track", name);
+            m_data = {};
+            return false;
+        }
+    }
+    m_header = header;
+    return true;
+}
+
+const Level::m_cached_chunk& Level::decode_chunk(LevelTrack track, std::uint32_t chunk) const
+{
+    m_cached_chunk& cached = m_cache[static_cast<std::size_t>(track)][chunk % m_cache_slots];
+    if (cached.chunk == chunk)
+    {
+        return cached;
+    }
+
+    const LevelFileTrack& file_track = m_header.tracks[static_cast<std::size_t>(track)];
+    LevelFileChunk file_chunk;
+    std::memcpy(&file_chunk, m_data.data() + level_file_chunk_offset +
+                             std::size_t(file_track.first_chunk + chunk) * sizeof(LevelFileChunk),
+                sizeof(file_chunk));
+
+    SpanType type = get_track_type(track);
+    std::uint32_t count = std::min(level_chunk_spans, file_track.span_count - chunk * level_chunk_spans);
+    for (std::uint32_t i = 0; i < count; i++)
+    {
+        const LevelFileSpan& span = file_chunk.spans[i];
+        if (span.type != type || span.width == 0 || span.height == 0)
+        {
+            log_error("LEVEL", "span {} is broken", chunk * level_chunk_spans + i);
+            cached.spans[i] = {type};
+            continue;
+        }
+        cached.spans[i] = {span.type, span.width, span.height, span.spacing};
+    }
+    cached.chunk = chunk;
+    m_decoded_chunks++;
+    return cached;
+}
+
+std::vector<std::byte> write_level(std::span<const LevelSpan> obstacles, std::span<const LevelSpan> decorations)
+{
+    std::span<const LevelSpan> tracks[level_track_count] = {obstacles, decorations};
+
+    LevelFileHeader header = {};
+    std::memcpy(header.magic, level_file_magic, sizeof(level_file_magic));
+    header.version = level_file_version;
+    header.chunk_spans = level_chunk_spans;
+    std::uint32_t chunk_count = 0;
+    for (std::size_t i = 0; i < level_track_count; i++)
+    {
+        header.tracks[i].span_count = static_cast<std::uint32_t>(tracks[i].size());
+        header.tracks[i].first_chunk = chunk_count;
+        chunk_count += get_chunk_count(header.tracks[i].span_count);
+    }
+    header.file_size = level_file_chunk_offset + std::uint64_t(chunk_count) * sizeof(LevelFileChunk);
+
+    std::vector<std::byte> image(header.file_size);
+    std::memcpy(image.data(), &header, sizeof(header));
+    for (std::size_t i = 0; i < level_track_count; i++)
+    {
+        std::byte* out = image.data() + level_file_chunk_offset +
+                         header.tracks[i].first_chunk * sizeof(LevelFileChunk);
+        for (const LevelSpan& span: tracks[i])
+        {
+            LevelFileSpan file_span = {span.type, 0, static_cast<std::uint16_t>(span.width),
+                                       static_cast<std::uint16_t>(span.height),
+                                       static_cast<std::uint16_t>(span.spacing)};
+            std::memcpy(out, &file_span, sizeof(file_span));
+            out += sizeof(file_span);
+        }
+    }
+    return image;
+}
+
+void generate_course(std::uint64_t seed, std::size_t length, std::vector<LevelSpan>& obstacles,
+                     std::vector<LevelSpan>& decorations)
+{
+    Random random{seed};
+    obstacles.reserve(obstacles.size() + length);
+    decorations.reserve(decorations.size() + length);
+    for (std::size_t i = 0; i < length; i++)
+    {
+        obstacles.push_back({SpanType::TRIANGLE, 50, 50, random.next_int(50) * 100 + 200});
+        int width = random.next_int(8) * 100 + 200;
+        int height = random.next_int(5) * 100 + 200;
+        // a decoration scrolls three of its widths past the edge before the next one comes in
+        decorations.push_back({SpanType::DECORATION, width, height, width * 3});
+    }
+}
+
+Level generate_level(std::uint64_t seed, std::size_t length)
+{
+    std::vector<LevelSpan> obstacles;
+    std::vector<LevelSpan> decorations;
+    generate_course(seed, length, obstacles, decorations);
+    Level level;
+    level.load(write_level(obstacles, decorations));
+    return level;
+}
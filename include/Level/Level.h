@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "MappedFile/MappedFile.h"
+
+/*
+ * A course is two tracks of spans. Each obstacle span is one obstacle
+ * crossing the screen: its size, and how far past the left edge it travels
+ * before the next one spawns on the right (its spacing). Decoration spans
+ * are the background triangles, on a track of their own.
+ *
+ *   LevelFileHeader
+ *   LevelFileChunk[]   from level_file_chunk_offset, the obstacle track's
+ *                      chunks, then the decoration track's
+ *
+ * Every chunk holds level_chunk_spans spans, the last one of a track is
+ * padded, so span i of a track is found without reading anything before
+ * it. Files are written by gl_jump_level from a text description, in host
+ * byte order like the asset pack.
+ */
+constexpr char level_file_magic[8] = {'G', 'L', 'J', 'L', 'E', 'V', 'L', '\0'};
+constexpr std::uint32_t level_file_version = 1;
+constexpr std::uint32_t level_chunk_spans = 64;
+constexpr std::size_t level_file_chunk_offset = 64;
+
+enum class LevelTrack : std::uint32_t
+{
+    OBSTACLES, DECORATIONS
+};
+
+constexpr std::size_t level_track_count = 2;
+
+enum class SpanType : std::uint8_t
+{
+    TRIANGLE, DECORATION
+};
+
+struct LevelSpan
+{
+    SpanType type = SpanType::TRIANGLE;
+    int width = 50;
+    int height = 50;
+    int spacing = 200;
+};
+
+struct LevelFileSpan
+{
+    SpanType type;
+    std::uint8_t reserved;
+    std::uint16_t width;
+    std::uint16_t height;
+    std::uint16_t spacing;
+};
+
+struct LevelFileChunk
+{
+    LevelFileSpan spans[level_chunk_spans];
+};
+
+struct LevelFileTrack
+{
+    std::uint32_t span_count;
+    // in chunks from level_file_chunk_offset
+    std::uint32_t first_chunk;
+};
+
+struct LevelFileHeader
+{
+    char magic[8];
+    std::uint32_t version;
+    std::uint32_t chunk_spans;
+    LevelFileTrack tracks[level_track_count];
+    std::uint64_t file_size;
+};
+
+static_assert(sizeof(LevelFileSpan) == 8);
+static_assert(sizeof(LevelFileHeader) <= level_file_chunk_offset);
+
+/*
+ * A course mapped from a level file, or held in memory when generated.
+ * Opening only checks the header. Spans are decoded a chunk at a time
+ * into a few cache slots per track, and every lookup also decodes the
+ * chunk after it and asks the OS to read ahead the one after that, so
+ * the scroll position never waits on either. Courses of any length run
+ * in the same memory; going back, for a rewind or a rollback, decodes
+ * an old chunk again.
+ * Lookups fill the cache, so a Level belongs to one thread at a time.
+ */
+class Level
+{
+public:
+    Level() = default;
+
+    bool open(const std::string& path);
+
+    // a whole level file held in memory, see write_level
+    bool load(std::vector<std::byte> image);
+
+    bool is_open() const;
+
+    std::uint32_t get_span_count(LevelTrack track) const;
+
+    // span index of track, wrapping around at the end of the track
+    const LevelSpan& get_span(LevelTrack track, std::uint32_t index) const;
+
+    // chunks decoded since opening
+    std::uint64_t get_decoded_chunks() const;
+
+private:
+    static constexpr std::size_t m_cache_slots = 4;
+
+    struct m_cached_chunk
+    {
+        std::uint32_t chunk = UINT32_MAX;
+        std::array<LevelSpan, level_chunk_spans> spans;
+    };
+
+    bool validate(const std::string& name);
+
+    const m_cached_chunk& decode_chunk(LevelTrack track, std::uint32_t chunk) const;
+
+    MappedFile m_file;
+    std::vector<std::byte> m_image;
+    std::span<const std::byte> m_data;
+    LevelFileHeader m_header{};
+
+    mutable std::array<std::array<m_cached_chunk, m_cache_slots>, level_track_count> m_cache;
+    mutable std::uint64_t m_decoded_chunks = 0;
+};
+
+// a complete level file holding the two tracks
+std::vector<std::byte> write_level(std::span<const LevelSpan> obstacles, std::span<const LevelSpan> decorations);
+
+// appends a random course of length obstacles and decorations
+void generate_course(std::uint64_t seed, std::size_t length, std::vector<LevelSpan>& obstacles,
+                     std::vector<LevelSpan>& decorations);
+
+// generate_course held in memory
+Level generate_level(std::uint64_t seed, std::size_t length);
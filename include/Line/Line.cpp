@@ -1,44 +1,8 @@
 #include "Line.h"
 
-void Line::draw(unsigned int shader_program, float r, float g, float b,
+void Line::draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g, float b,
                 GLuint start_x, GLuint start_y, GLuint end_x, GLuint end_y)
 {
-    glUseProgram(shader_program);
-    glUniform3f(glGetUniformLocation(shader_program, "color"), r, g, b);
-    /*
-    *   A --- B
-    */
-    std::array<GLuint, 8> vertices{
-            start_x, start_y,  // A
-            end_x, end_y,      // B
-    };
-
-    std::array<GLuint, 2> indices{
-            0, 1,
-    };
-
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLuint),
-                 vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, 2 * sizeof(GLuint),
-                          (const void*) 0);
-    glEnableVertexAttribArray(0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int),
-                 indices.data(), GL_STATIC_DRAW);
-
-    glDrawElements(GL_LINES, indices.size(), GL_UNSIGNED_INT, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    glm::vec2 start(start_x, start_y);
+    primitives.draw(queue, primitive::LINE, layer, start, glm::vec2(end_x, end_y) - start, r, g, b);
 }
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <glbinding/gl/gl.h>
 
+#include "gl_primitives/gl_primitives.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+
 using namespace gl;
 
 class Line
@@ -10,6 +13,6 @@ class Line
 public:
     Line() = default;
     ~Line() = default;
-    void draw(unsigned int shader_program, float r, float g, float b,
+    void draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g, float b,
               GLuint start_x, GLuint start_y, GLuint end_x, GLuint end_y);
 };
@@ -0,0 +1,323 @@
+#include "Logger.h"
+
+#include <cinttypes>
+
+namespace
+{
+    const char* get_level_name(log_level level)
+    {
+        switch (level)
+        {
+            case log_level::DEBUG:
+                return "DEBUG";
+            case log_level::INFO:
+                return "INFO";
+            case log_level::WARNING:
+                return "WARNING";
+            case log_level::ERROR:
+                return "ERROR";
+        }
+        return "?";
+    }
+
+    constexpr std::chrono::milliseconds drain_interval{5};
+}
+
+// a thread's claim on a ring, handed back when the thread exits
+struct logger_thread_ring
+{
+    ~logger_thread_ring()
+    {
+        if (ring)
+        {
+            ring->retired.store(true, std::memory_order_release);
+        }
+    }
+
+    Logger::m_ring* ring = nullptr;
+};
+
+std::byte* Logger::m_ring::reserve(std::size_t size)
+{
+    std::uint64_t position = write.load(std::memory_order_relaxed);
+    std::uint64_t offset = position % ring_bytes;
+    // records don't wrap, whatever is left at the end of the ring is skipped
+    std::uint64_t padding = ring_bytes - offset < size ? ring_bytes - offset : 0;
+    if (position + padding + size - read.load(std::memory_order_acquire) > ring_bytes)
+    {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return nullptr;
+    }
+    // too little room for a header is skipped without one
+    if (padding >= sizeof(m_record))
+    {
+        m_record skip{static_cast<std::uint32_t>(padding), log_level::DEBUG, 0, 0, 0, nullptr, nullptr};
+        std::memcpy(bytes.get() + offset, &skip, sizeof(skip));
+    }
+    position += padding;
+    reserved_end = position + size;
+    return bytes.get() + position % ring_bytes;
+}
+
+void Logger::m_ring::commit()
+{
+    write.store(reserved_end, std::memory_order_release);
+}
+
+bool Logger::m_ring::take_retired()
+{
+    // the thread is gone and everything it wrote is out. the logger's thread and a thread
+    // looking for a ring may both get here, only one of them takes it
+    if (!retired.load(std::memory_order_acquire) ||
+        read.load(std::memory_order_acquire) != write.load(std::memory_order_acquire))
+    {
+        return false;
+    }
+    bool expected = true;
+    return retired.compare_exchange_strong(expected, false, std::memory_order_acq_rel);
+}
+
+Logger::Logger()
+        : m_start(std::chrono::steady_clock::now())
+{
+    for (m_ring& ring: m_rings)
+    {
+        ring.bytes = std::make_unique<std::byte[]>(ring_bytes);
+    }
+    m_line.reserve(4096);
+    m_thread = std::thread([this]
+                           {
+                               run();
+                           });
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_one();
+    m_thread.join();
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+}
+
+bool Logger::open_file(const std::string& path)
+{
+    std::FILE* file = std::fopen(path.c_str(), "w");
+    if (!file)
+    {
+        log_error("LOG", "Failed to open {}", path);
+        return false;
+    }
+    std::lock_guard lock(m_mutex);
+    if (m_file)
+    {
+        std::fclose(m_file);
+    }
+    m_file = file;
+    m_output = file;
+    return true;
+}
+
+void Logger::flush()
+{
+    std::array<std::uint64_t, max_threads> written{};
+    for (std::size_t i = 0; i < max_threads; i++)
+    {
+        written[i] = m_rings[i].write.load(std::memory_order_acquire);
+    }
+    for (std::size_t i = 0; i < max_threads; i++)
+    {
+        while (m_rings[i].read.load(std::memory_order_acquire) < written[i])
+        {
+            m_wake.notify_one();
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    }
+    // formatted, now out of stdio's buffer too
+    std::lock_guard lock(m_mutex);
+    std::fflush(m_output);
+}
+
+std::uint64_t Logger::get_dropped() const
+{
+    std::uint64_t dropped = m_unowned_dropped.load(std::memory_order_relaxed);
+    for (const m_ring& ring: m_rings)
+    {
+        dropped += ring.dropped.load(std::memory_order_relaxed);
+    }
+    return dropped;
+}
+
+std::uint64_t Logger::get_timestamp() const
+{
+    return static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count());
+}
+
+Logger::m_ring* Logger::get_thread_ring()
+{
+    thread_local logger_thread_ring thread_ring;
+    if (!thread_ring.ring)
+    {
+        // with every ring taken the record is dropped, rings of exited threads come free once drained
+        for (m_ring& ring: m_rings)
+        {
+            if (ring.owned.exchange(true, std::memory_order_acquire) == false || ring.take_retired())
+            {
+                thread_ring.ring = &ring;
+                break;
+            }
+        }
+    }
+    return thread_ring.ring;
+}
+
+void Logger::run()
+{
+    std::unique_lock lock(m_mutex);
+    while (!m_stop)
+    {
+        m_wake.wait_for(lock, drain_interval);
+        while (drain())
+        {
+        }
+    }
+    while (drain())
+    {
+    }
+}
+
+bool Logger::drain()
+{
+    bool any = false;
+    for (;;)
+    {
+        // the oldest record at the head of any ring goes next
+        m_ring* next = nullptr;
+        const m_record* next_record = nullptr;
+        for (m_ring& ring: m_rings)
+        {
+            std::uint64_t read = ring.read.load(std::memory_order_relaxed);
+            std::uint64_t write = ring.write.load(std::memory_order_acquire);
+            if (read == write)
+            {
+                continue;
+            }
+            if (ring_bytes - read % ring_bytes < sizeof(m_record))
+            {
+                ring.read.store(read + ring_bytes - read % ring_bytes, std::memory_order_release);
+                continue;
+            }
+            auto* record = reinterpret_cast<const m_record*>(ring.bytes.get() + read % ring_bytes);
+            if (!record->format)
+            {
+                ring.read.store(read + record->size, std::memory_order_release);
+                continue;
+            }
+            if (!next_record || record->timestamp < next_record->timestamp)
+            {
+                next = &ring;
+                next_record = record;
+            }
+        }
+        if (!next)
+        {
+            break;
+        }
+        format_record(*next_record, reinterpret_cast<const std::byte*>(next_record + 1));
+        next->read.store(next->read.load(std::memory_order_relaxed) + next_record->size, std::memory_order_release);
+        any = true;
+    }
+
+    std::uint64_t dropped = m_unowned_dropped.load(std::memory_order_relaxed) - m_reported_unowned;
+    m_reported_unowned += dropped;
+    for (m_ring& ring: m_rings)
+    {
+        std::uint64_t ring_dropped = ring.dropped.load(std::memory_order_relaxed);
+        dropped += ring_dropped - ring.reported_dropped;
+        ring.reported_dropped = ring_dropped;
+
+        if (ring.take_retired())
+        {
+            ring.owned.store(false, std::memory_order_release);
+        }
+    }
+    if (dropped > 0)
+    {
+        std::fprintf(m_output, "WARNING::LOG: %" PRIu64 " records dropped, the rings were full\n", dropped);
+    }
+    if (any || dropped > 0)
+    {
+        std::fflush(m_output);
+    }
+    return any;
+}
+
+void Logger::format_record(const m_record& record, const std::byte* arguments)
+{
+    m_line.clear();
+    char number[32];
+    std::snprintf(number, sizeof(number), "[%10.6f] ", static_cast<double>(record.timestamp) * 1e-9);
+    m_line += number;
+    m_line += get_level_name(record.level);
+    m_line += "::";
+    m_line += record.module;
+    m_line += ": ";
+
+    std::uint8_t remaining = record.argument_count;
+    for (const char* c = record.format; *c; c++)
+    {
+        bool hex = std::strncmp(c, "{:x}", 4) == 0;
+        if ((!hex && std::strncmp(c, "{}", 2) != 0) || remaining == 0)
+        {
+            m_line += *c;
+            continue;
+        }
+        c += hex ? 3 : 1;
+        remaining--;
+
+        auto type = static_cast<m_argument>(*arguments++);
+        if (type == m_argument::STRING)
+        {
+            std::uint16_t length;
+            std::memcpy(&length, arguments, sizeof(length));
+            arguments += sizeof(length);
+            m_line.append(reinterpret_cast<const char*>(arguments), length);
+            arguments += length;
+            continue;
+        }
+        std::uint64_t bits;
+        std::memcpy(&bits, arguments, sizeof(bits));
+        arguments += sizeof(bits);
+        if (type == m_argument::DOUBLE)
+        {
+            double value;
+            std::memcpy(&value, &bits, sizeof(value));
+            // what std::cout would print
+            std::snprintf(number, sizeof(number), "%g", value);
+        } else if (hex)
+        {
+            std::snprintf(number, sizeof(number), "%" PRIx64, bits);
+        } else if (type == m_argument::INT)
+        {
+            std::snprintf(number, sizeof(number), "%" PRId64, static_cast<std::int64_t>(bits));
+        } else
+        {
+            std::snprintf(number, sizeof(number), "%" PRIu64, bits);
+        }
+        m_line += number;
+    }
+    m_line += '\n';
+    std::fwrite(m_line.data(), 1, m_line.size(), m_output);
+}
+
+Logger& get_logger()
+{
+    static Logger logger;
+    return logger;
+}
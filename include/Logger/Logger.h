@@ -0,0 +1,244 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+// levels below this are compiled out, set with the CMake cache variable of the same name
+#ifndef GL_JUMP_LOG_LEVEL
+#define GL_JUMP_LOG_LEVEL 1
+#endif
+
+enum class log_level : std::uint8_t
+{
+    DEBUG, INFO, WARNING, ERROR
+};
+
+inline constexpr log_level compiled_log_level = static_cast<log_level>(GL_JUMP_LOG_LEVEL);
+
+/*
+ * Asynchronous logger. A logging thread writes a small binary record into
+ * a ring of its own: a timestamp, the level, pointers to the module and
+ * format string literals and the arguments, strings copied. A background
+ * thread merges the rings by timestamp, formats the records and writes
+ * them to stderr or a file. The hot path takes no lock, makes no system
+ * call and never waits; when a ring is full the record is dropped and
+ * counted, and the drops are reported in the log.
+ *
+ * Formats replace each {} with the next argument, {:x} prints an integer
+ * in hex. Use log_error and friends rather than write, they compile away
+ * below GL_JUMP_LOG_LEVEL.
+ */
+class Logger
+{
+public:
+    // rings that can be owned at once, a thread's ring is freed after it exits
+    static constexpr std::size_t max_threads = 16;
+    static constexpr std::size_t ring_bytes = 64 * 1024;
+    // longer strings are cut
+    static constexpr std::size_t max_string = 1024;
+
+    Logger();
+
+    // writes out what's left
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+
+    Logger& operator=(const Logger&) = delete;
+
+    // from now on to path instead of stderr
+    bool open_file(const std::string& path);
+
+    // returns once everything logged before the call is written out
+    void flush();
+
+    std::uint64_t get_dropped() const;
+
+    template<typename... Args>
+    void write(log_level level, const char* module, const char* format, const Args&... args)
+    {
+        m_ring* ring = get_thread_ring();
+        if (!ring)
+        {
+            m_unowned_dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        std::size_t size = (sizeof(m_record) + ... + get_encoded_size(args));
+        size = (size + alignof(m_record) - 1) / alignof(m_record) * alignof(m_record);
+        std::byte* out = ring->reserve(size);
+        if (!out)
+        {
+            return;
+        }
+        m_record record{static_cast<std::uint32_t>(size), level, static_cast<std::uint8_t>(sizeof...(Args)), 0,
+                        get_timestamp(), module, format};
+        std::memcpy(out, &record, sizeof(record));
+        out += sizeof(record);
+        (encode(out, args), ...);
+        ring->commit();
+    }
+
+private:
+    enum class m_argument : std::uint8_t
+    {
+        INT, UINT, DOUBLE, STRING
+    };
+
+    struct m_record
+    {
+        // the whole record, a multiple of 8. padding up to the end of the ring has no format
+        std::uint32_t size;
+        log_level level;
+        std::uint8_t argument_count;
+        std::uint16_t reserved;
+        std::uint64_t timestamp;
+        const char* module;
+        const char* format;
+    };
+
+    // one producer thread, the logger's thread consumes
+    struct m_ring
+    {
+        std::byte* reserve(std::size_t size);
+
+        void commit();
+
+        // false unless the ring's thread exited and it's drained, then it's no longer retired
+        bool take_retired();
+
+        std::unique_ptr<std::byte[]> bytes;
+        std::atomic<std::uint64_t> write{0};
+        std::atomic<std::uint64_t> read{0};
+        std::atomic<std::uint64_t> dropped{0};
+        std::atomic<bool> owned{false};
+        std::atomic<bool> retired{false};
+        // producer side, where the reserved record ends
+        std::uint64_t reserved_end = 0;
+        // consumer side, drops already reported
+        std::uint64_t reported_dropped = 0;
+    };
+
+    friend struct logger_thread_ring;
+
+    template<typename T>
+    static std::size_t get_encoded_size(const T& value)
+    {
+        if constexpr (std::is_arithmetic_v<T> || std::is_enum_v<T>)
+        {
+            return 1 + 8;
+        } else
+        {
+            return 1 + sizeof(std::uint16_t) + std::min(std::string_view(value).size(), max_string);
+        }
+    }
+
+    template<typename T>
+    static void encode(std::byte*& out, const T& value)
+    {
+        if constexpr (std::is_enum_v<T>)
+        {
+            encode(out, static_cast<std::underlying_type_t<T>>(value));
+        } else if constexpr (std::is_floating_point_v<T>)
+        {
+            encode_value(out, m_argument::DOUBLE, static_cast<double>(value));
+        } else if constexpr (std::is_integral_v<T> && std::is_signed_v<T>)
+        {
+            encode_value(out, m_argument::INT, static_cast<std::int64_t>(value));
+        } else if constexpr (std::is_integral_v<T>)
+        {
+            encode_value(out, m_argument::UINT, static_cast<std::uint64_t>(value));
+        } else
+        {
+            std::string_view text(value);
+            auto length = static_cast<std::uint16_t>(std::min(text.size(), max_string));
+            encode_value(out, m_argument::STRING, length);
+            std::memcpy(out, text.data(), length);
+            out += length;
+        }
+    }
+
+    template<typename T>
+    static void encode_value(std::byte*& out, m_argument type, T value)
+    {
+        *out++ = static_cast<std::byte>(type);
+        std::memcpy(out, &value, sizeof(value));
+        out += sizeof(value);
+    }
+
+    std::uint64_t get_timestamp() const;
+
+    m_ring* get_thread_ring();
+
+    void run();
+
+    // formats everything committed so far in timestamp order, false when there was nothing
+    bool drain();
+
+    void format_record(const m_record& record, const std::byte* arguments);
+
+    std::array<m_ring, max_threads> m_rings;
+    std::atomic<std::uint64_t> m_unowned_dropped{0};
+    std::uint64_t m_reported_unowned = 0;
+    std::chrono::steady_clock::time_point m_start;
+
+    // only the logger's thread touches these after construction, open_file swaps under the mutex
+    std::FILE* m_output = stderr;
+    std::FILE* m_file = nullptr;
+    std::string m_line;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop = false;
+    std::thread m_thread;
+};
+
+Logger& get_logger();
+
+template<std::size_t M, std::size_t F, typename... Args>
+void log_debug(const char (&module)[M], const char (&format)[F], const Args&... args)
+{
+    if constexpr (log_level::DEBUG >= compiled_log_level)
+    {
+        get_logger().write(log_level::DEBUG, module, format, args...);
+    }
+}
+
+template<std::size_t M, std::size_t F, typename... Args>
+void log_info(const char (&module)[M], const char (&format)[F], const Args&... args)
+{
+    if constexpr (log_level::INFO >= compiled_log_level)
+    {
+        get_logger().write(log_level::INFO, module, format, args...);
+    }
+}
+
+template<std::size_t M, std::size_t F, typename... Args>
+void log_warning(const char (&module)[M], const char (&format)[F], const Args&... args)
+{
+    if constexpr (log_level::WARNING >= compiled_log_level)
+    {
+        get_logger().write(log_level::WARNING, module, format, args...);
+    }
+}
+
+template<std::size_t M, std::size_t F, typename... Args>
+void log_error(const char (&module)[M], const char (&format)[F], const Args&... args)
+{
+    if constexpr (log_level::ERROR >= compiled_log_level)
+    {
+        get_logger().write(log_level::ERROR, module, format, args...);
+    }
+}
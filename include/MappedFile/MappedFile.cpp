@@ -0,0 +1,100 @@
+#include "MappedFile.h"
+
+#include <algorithm>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "Logger/Logger.h"
+
+MappedFile::~MappedFile()
+{
+    close();
+}
+
+MappedFile::MappedFile(MappedFile&& other) noexcept
+        : m_data(std::exchange(other.m_data, nullptr)),
+          m_size(std::exchange(other.m_size, 0))
+{
+
+}
+
+MappedFile& MappedFile::operator=(MappedFile&& other) noexcept
+{
+    if (this != &other)
+    {
+        close();
+        m_data = std::exchange(other.m_data, nullptr);
+        m_size = std::exchange(other.m_size, 0);
+    }
+    return *this;
+}
+
+bool MappedFile::open(const std::string& path)
+{
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0)
+    {
+        log_error("MAPPED_FILE", "Failed to open {}", path);
+        return false;
+    }
+
+    struct stat info = {};
+    if (fstat(fd, &info) != 0 || info.st_size == 0)
+    {
+        log_error("MAPPED_FILE", "Failed to stat or empty file {}", path);
+        ::close(fd);
+        return false;
+    }
+
+    void* data = mmap(nullptr, info.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    // the mapping stays valid after the descriptor is closed
+    ::close(fd);
+    if (data == MAP_FAILED)
+    {
+        log_error("MAPPED_FILE", "Failed to map {}", path);
+        return false;
+    }
+
+    m_data = static_cast<const std::byte*>(data);
+    m_size = info.st_size;
+    return true;
+}
+
+void MappedFile::close()
+{
+    if (m_data)
+    {
+        munmap(const_cast<std::byte*>(m_data), m_size);
+        m_data = nullptr;
+        m_size = 0;
+    }
+}
+
+bool MappedFile::is_open() const
+{
+    return m_data != nullptr;
+}
+
+std::span<const std::byte> MappedFile::get_data() const
+{
+    return {m_data, m_size};
+}
+
+void MappedFile::advise_will_need(std::size_t offset, std::size_t size) const
+{
+    if (!m_data || offset >= m_size)
+    {
+        return;
+    }
+    // madvise wants a page aligned start
+    static const std::size_t page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+    std::size_t begin = offset / page_size * page_size;
+    std::size_t end = std::min(offset + size, m_size);
+    madvise(const_cast<std::byte*>(m_data) + begin, end - begin, MADV_WILLNEED);
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstddef>
+#include <span>
+#include <string>
+
+/*
+ * Read-only memory mapping of a whole file. Pages are shared with every
+ * other process mapping the same file and are only read in when touched.
+ */
+class MappedFile
+{
+public:
+    MappedFile() = default;
+
+    ~MappedFile();
+
+    MappedFile(MappedFile&& other) noexcept;
+
+    MappedFile& operator=(MappedFile&& other) noexcept;
+
+    MappedFile(const MappedFile&) = delete;
+
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    bool open(const std::string& path);
+
+    void close();
+
+    bool is_open() const;
+
+    std::span<const std::byte> get_data() const;
+
+    // hints the OS to start reading [offset, offset + size) in, does nothing when not open
+    void advise_will_need(std::size_t offset, std::size_t size) const;
+
+private:
+    const std::byte* m_data = nullptr;
+    std::size_t m_size = 0;
+};
@@ -0,0 +1,133 @@
+#include "ParticleSystem.h"
+
+#include <algorithm>
+
+namespace
+{
+    std::uint32_t pack_color(std::array<float, 3> color)
+    {
+        auto channel = [](float value)
+        {
+            return static_cast<std::uint32_t>(std::clamp(value, 0.0f, 1.0f) * 255.0f + 0.5f);
+        };
+        // bytes in memory are R, G, B, A on the little endian targets we build for
+        return channel(color[0]) | (channel(color[1]) << 8) | (channel(color[2]) << 16);
+    }
+
+    float spread(Random& random, float amount)
+    {
+        return (random.next_float() * 2.0f - 1.0f) * amount;
+    }
+}
+
+ParticleSystem::ParticleSystem(std::size_t capacity, float gravity, float ground_y)
+        : m_capacity(capacity),
+          m_gravity(gravity),
+          m_ground_y(ground_y),
+          m_position_x(new float[capacity]),
+          m_position_y(new float[capacity]),
+          m_velocity_x(new float[capacity]),
+          m_velocity_y(new float[capacity]),
+          m_life(new float[capacity]),
+          m_fade(new float[capacity]),
+          m_size(new float[capacity]),
+          m_color(new std::uint32_t[capacity])
+{
+
+}
+
+void ParticleSystem::emit(const ParticleEmitter& emitter, std::size_t count, Random& random)
+{
+    std::size_t end = std::min(m_count + count, m_capacity);
+    std::uint32_t color = pack_color(emitter.color);
+    for (std::size_t i = m_count; i < end; i++)
+    {
+        m_position_x[i] = emitter.position.x + spread(random, emitter.position_spread.x);
+        m_position_y[i] = emitter.position.y + spread(random, emitter.position_spread.y);
+        m_velocity_x[i] = emitter.velocity.x + spread(random, emitter.velocity_spread.x);
+        m_velocity_y[i] = emitter.velocity.y + spread(random, emitter.velocity_spread.y);
+        m_life[i] = std::max(emitter.life + spread(random, emitter.life_spread), 0.001f);
+        m_fade[i] = 1.0f / m_life[i];
+        m_size[i] = emitter.size;
+        m_color[i] = color;
+    }
+    m_count = end;
+}
+
+void ParticleSystem::update(float delta_time)
+{
+    // separate loops over restrict pointers, each one vectorizes on its own
+    float* __restrict position_x = m_position_x.get();
+    float* __restrict position_y = m_position_y.get();
+    float* __restrict velocity_x = m_velocity_x.get();
+    float* __restrict velocity_y = m_velocity_y.get();
+    float* __restrict life = m_life.get();
+    const std::size_t count = m_count;
+    const float fall = m_gravity * delta_time;
+    const float ground_y = m_ground_y;
+
+    for (std::size_t i = 0; i < count; i++)
+    {
+        velocity_y[i] -= fall;
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        position_x[i] += velocity_x[i] * delta_time;
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        position_y[i] = std::max(position_y[i] + velocity_y[i] * delta_time, ground_y);
+    }
+    for (std::size_t i = 0; i < count; i++)
+    {
+        life[i] -= delta_time;
+    }
+
+    // keep the live ones packed at the front by moving the last one into each hole,
+    // order doesn't matter for points and only expired particles cost anything
+    std::size_t live = count;
+    for (std::size_t i = 0; i < live;)
+    {
+        if (life[i] > 0.0f)
+        {
+            i++;
+            continue;
+        }
+        live--;
+        position_x[i] = position_x[live];
+        position_y[i] = position_y[live];
+        velocity_x[i] = velocity_x[live];
+        velocity_y[i] = velocity_y[live];
+        life[i] = life[live];
+        m_fade[i] = m_fade[live];
+        m_size[i] = m_size[live];
+        m_color[i] = m_color[live];
+    }
+    m_count = live;
+}
+
+std::size_t ParticleSystem::write_vertices(std::span<vertex> vertices) const
+{
+    std::size_t count = std::min(m_count, vertices.size());
+    for (std::size_t i = 0; i < count; i++)
+    {
+        auto alpha = static_cast<std::uint32_t>(std::min(m_life[i] * m_fade[i], 1.0f) * 255.0f);
+        vertices[i] = {{m_position_x[i], m_position_y[i]}, m_size[i], m_color[i] | (alpha << 24)};
+    }
+    return count;
+}
+
+void ParticleSystem::clear()
+{
+    m_count = 0;
+}
+
+std::size_t ParticleSystem::get_count() const
+{
+    return m_count;
+}
+
+std::size_t ParticleSystem::get_capacity() const
+{
+    return m_capacity;
+}
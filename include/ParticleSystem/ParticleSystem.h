@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <span>
+
+#include <glm/glm.hpp>
+
+#include "Random/Random.h"
+
+// what a burst of particles looks like, velocity and life are randomized by +- their spread
+struct ParticleEmitter
+{
+    glm::vec2 position{};
+    glm::vec2 position_spread{};
+    glm::vec2 velocity{};
+    glm::vec2 velocity_spread{};
+    float life = 1.0f;
+    float life_spread = 0.0f;
+    float size = 2.0f;
+    std::array<float, 3> color{1.0f, 1.0f, 1.0f};
+};
+
+/*
+ * Fixed capacity CPU particles stored as structure of arrays, so
+ * integration is a handful of straight loops over floats the compiler
+ * can vectorize. Live particles are always packed into [0, get_count()),
+ * expired ones are compacted away in place during update(), and
+ * write_vertices() emits one point per particle for a single draw.
+ * Nothing here allocates after construction or touches GL.
+ */
+class ParticleSystem
+{
+public:
+    // layout of one point in the vertex stream, see gl_particles
+    struct vertex
+    {
+        glm::vec2 position;
+        float size;
+        std::uint32_t color; // RGBA8, alpha fades with remaining life
+    };
+
+    // particles don't fall below ground_y
+    ParticleSystem(std::size_t capacity, float gravity, float ground_y);
+
+    // spawns up to count particles, stops quietly when full
+    void emit(const ParticleEmitter& emitter, std::size_t count, Random& random);
+
+    void update(float delta_time);
+
+    // writes min(get_count(), vertices.size()) points, returns how many
+    std::size_t write_vertices(std::span<vertex> vertices) const;
+
+    void clear();
+
+    std::size_t get_count() const;
+
+    std::size_t get_capacity() const;
+
+private:
+    std::size_t m_capacity;
+    std::size_t m_count = 0;
+    float m_gravity;
+    float m_ground_y;
+
+    std::unique_ptr<float[]> m_position_x;
+    std::unique_ptr<float[]> m_position_y;
+    std::unique_ptr<float[]> m_velocity_x;
+    std::unique_ptr<float[]> m_velocity_y;
+    std::unique_ptr<float[]> m_life;
+    // 1 / starting life, so the fade is a multiply
+    std::unique_ptr<float[]> m_fade;
+    std::unique_ptr<float[]> m_size;
+    // RGB8, alpha is filled in from the life
+    std::unique_ptr<std::uint32_t[]> m_color;
+};
@@ -0,0 +1,187 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <numbers>
+
+/*
+ * Unit meshes built at compile time. Every shape fits the unit square and
+ * is placed with a scale and an offset when drawn, so the vertex and index
+ * data below ends up as constants in read-only memory and gl_primitives
+ * uploads all of it once. A new shape is a make_ function, an entry in
+ * primitive and one more argument to make_primitive_library.
+ */
+struct primitive_vertex
+{
+    float x = 0.0f;
+    float y = 0.0f;
+};
+
+template<std::size_t V, std::size_t I>
+struct primitive_mesh
+{
+    static constexpr std::size_t vertex_count = V;
+    static constexpr std::size_t index_count = I;
+
+    std::array<primitive_vertex, V> vertices{};
+    std::array<std::uint32_t, I> indices{};
+    // GL_LINES instead of GL_TRIANGLES
+    bool lines = false;
+};
+
+// where a mesh ended up in the library's index buffer
+struct primitive_range
+{
+    std::uint32_t first = 0;
+    std::uint32_t count = 0;
+    bool lines = false;
+};
+
+template<std::size_t V, std::size_t I, std::size_t N>
+struct primitive_library
+{
+    std::array<primitive_vertex, V> vertices{};
+    std::array<std::uint32_t, I> indices{};
+    std::array<primitive_range, N> ranges{};
+};
+
+namespace primitive_math
+{
+    // std::sin isn't constexpr yet, a Taylor series is plenty for a few dozen segments
+    constexpr double sin(double x)
+    {
+        while (x > std::numbers::pi)
+        {
+            x -= 2.0 * std::numbers::pi;
+        }
+        while (x < -std::numbers::pi)
+        {
+            x += 2.0 * std::numbers::pi;
+        }
+        double term = x;
+        double sum = x;
+        for (int i = 1; i < 12; i++)
+        {
+            term *= -x * x / ((2 * i) * (2 * i + 1));
+            sum += term;
+        }
+        return sum;
+    }
+
+    constexpr double cos(double x)
+    {
+        return sin(x + std::numbers::pi / 2.0);
+    }
+}
+
+/*
+ *   B - C
+ *   | / |
+ *   A - D
+ */
+constexpr primitive_mesh<4, 6> make_quad()
+{
+    return {{{{0, 0}, {0, 1}, {1, 1}, {1, 0}}}, {0, 1, 2, 0, 2, 3}};
+}
+
+/*
+ *     B
+ *    / \
+ *   A - C
+ */
+constexpr primitive_mesh<3, 3> make_triangle()
+{
+    return {{{{0, 0}, {0.5f, 1}, {1, 0}}}, {0, 1, 2}};
+}
+
+// from the offset to offset + size, which may point anywhere
+constexpr primitive_mesh<2, 2> make_line()
+{
+    return {{{{0, 0}, {1, 1}}}, {0, 1}, true};
+}
+
+// a fan around the centre of the unit square
+template<std::size_t Segments>
+constexpr primitive_mesh<Segments + 1, Segments * 3> make_circle()
+{
+    primitive_mesh<Segments + 1, Segments * 3> mesh;
+    mesh.vertices[0] = {0.5f, 0.5f};
+    for (std::size_t i = 0; i < Segments; i++)
+    {
+        double angle = 2.0 * std::numbers::pi * static_cast<double>(i) / Segments;
+        mesh.vertices[i + 1] = {static_cast<float>(0.5 + 0.5 * primitive_math::cos(angle)),
+                                static_cast<float>(0.5 + 0.5 * primitive_math::sin(angle))};
+        mesh.indices[i * 3] = 0;
+        mesh.indices[i * 3 + 1] = static_cast<std::uint32_t>(i + 1);
+        mesh.indices[i * 3 + 2] = static_cast<std::uint32_t>((i + 1) % Segments + 1);
+    }
+    return mesh;
+}
+
+// radius is a fraction of the unit square, the corners stretch with the scale when it isn't uniform
+template<std::size_t CornerSegments>
+constexpr primitive_mesh<1 + 4 * (CornerSegments + 1), 3 * 4 * (CornerSegments + 1)> make_rounded_rect(float radius)
+{
+    constexpr std::size_t outline = 4 * (CornerSegments + 1);
+    primitive_mesh<1 + outline, 3 * outline> mesh;
+    mesh.vertices[0] = {0.5f, 0.5f};
+    // corner centres counter-clockwise from the top right, each arc turning another quarter
+    const primitive_vertex centres[4] = {{1 - radius, 1 - radius}, {radius, 1 - radius}, {radius, radius},
+                                         {1 - radius, radius}};
+    std::size_t vertex = 1;
+    for (std::size_t corner = 0; corner < 4; corner++)
+    {
+        for (std::size_t i = 0; i <= CornerSegments; i++)
+        {
+            double angle = std::numbers::pi / 2.0 * (static_cast<double>(corner) +
+                                                     static_cast<double>(i) / CornerSegments);
+            mesh.vertices[vertex++] = {static_cast<float>(centres[corner].x + radius * primitive_math::cos(angle)),
+                                       static_cast<float>(centres[corner].y + radius * primitive_math::sin(angle))};
+        }
+    }
+    for (std::size_t i = 0; i < outline; i++)
+    {
+        mesh.indices[i * 3] = 0;
+        mesh.indices[i * 3 + 1] = static_cast<std::uint32_t>(i + 1);
+        mesh.indices[i * 3 + 2] = static_cast<std::uint32_t>((i + 1) % outline + 1);
+    }
+    return mesh;
+}
+
+// one vertex and one index buffer holding every mesh, indices rebased onto the shared vertices
+template<typename... Meshes>
+constexpr auto make_primitive_library(const Meshes&... meshes)
+{
+    primitive_library<(Meshes::vertex_count + ...), (Meshes::index_count + ...), sizeof...(Meshes)> library;
+    std::uint32_t vertex_offset = 0;
+    std::uint32_t index_offset = 0;
+    std::size_t range = 0;
+    auto append = [&](const auto& mesh)
+    {
+        for (std::size_t i = 0; i < mesh.vertices.size(); i++)
+        {
+            library.vertices[vertex_offset + i] = mesh.vertices[i];
+        }
+        for (std::size_t i = 0; i < mesh.indices.size(); i++)
+        {
+            library.indices[index_offset + i] = vertex_offset + mesh.indices[i];
+        }
+        library.ranges[range++] = {index_offset, static_cast<std::uint32_t>(mesh.indices.size()), mesh.lines};
+        vertex_offset += static_cast<std::uint32_t>(mesh.vertices.size());
+        index_offset += static_cast<std::uint32_t>(mesh.indices.size());
+    };
+    (append(meshes), ...);
+    return library;
+}
+
+// in the order they're passed to make_primitive_library
+enum class primitive : std::uint32_t
+{
+    QUAD, TRIANGLE, LINE, CIRCLE, ROUNDED_RECT, COUNT
+};
+
+inline constexpr auto primitive_meshes = make_primitive_library(make_quad(), make_triangle(), make_line(),
+                                                                make_circle<32>(), make_rounded_rect<6>(0.2f));
+
+static_assert(primitive_meshes.ranges.size() == static_cast<std::size_t>(primitive::COUNT));
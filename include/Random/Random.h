@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+
+/*
+ * Small seedable generator (splitmix64) for code that needs its own
+ * reproducible stream instead of the global rand() state.
+ * Trivially copyable so it can live inside snapshot-able state.
+ */
+struct Random
+{
+    std::uint64_t state = 0;
+
+    std::uint64_t next()
+    {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return z ^ (z >> 31);
+    }
+
+    // uniform in [0, bound), same role as rand() % bound
+    int next_int(int bound)
+    {
+        return static_cast<int>(((next() >> 32) * static_cast<std::uint64_t>(bound)) >> 32);
+    }
+
+    // uniform in [0, 1)
+    float next_float()
+    {
+        return static_cast<float>(next() >> 40) * (1.0f / 16777216.0f);
+    }
+};
@@ -10,70 +10,26 @@ Rectangle::Rectangle(int rectangle_width, int rectangle_height,
 
 }
 
-Rectangle::~Rectangle()
+void Rectangle::draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g,
+                     float b)
 {
-
+    primitives.draw(queue, primitive::QUAD, layer, glm::vec2(rectangle_pos_x, rectangle_pos_y),
+                    glm::vec2(rectangle_width, rectangle_height), r, g, b);
 }
 
-void Rectangle::draw(unsigned int shader_program, float r, float g, float b)
+void Rectangle::jump()
 {
-    glUseProgram(shader_program);
-    glUniform3f(glGetUniformLocation(shader_program, "color"), r, g, b);
-    /*
-    *   B - C
-    *   | / |
-    *   A - D
-    */
-    std::array<int, 8> vertices{
-            rectangle_pos_x,
-            rectangle_pos_y,                       // A
-            rectangle_pos_x,
-            rectangle_pos_y + rectangle_height,    // B
-            rectangle_pos_x + rectangle_width,
-            rectangle_pos_y + rectangle_height,    // C
-            rectangle_pos_x + rectangle_width,
-            rectangle_pos_y                        // D
-    };
-
-    std::array<GLuint, 6> indices{
-            0, 1, 2,
-            0, 2, 3
-    };
-
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(int),
-                 vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, 2 * sizeof(int),
-                          (const void*) 0);
-    glEnableVertexAttribArray(0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int),
-                 indices.data(), GL_STATIC_DRAW);
-
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
-
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    apply_jump(rectangle_pos_y, jump_amount, jump_state);
 }
 
-void Rectangle::jump()
+void apply_jump(int& pos_y, int& jump_amount, bool& jump_state)
 {
-    rectangle_pos_y += jump_amount;
-    if (rectangle_pos_y > 250)
+    pos_y += jump_amount;
+    if (pos_y > 250)
     {
         jump_amount = -10;
     }
-    if (rectangle_pos_y <= 100)
+    if (pos_y <= 100)
     {
         jump_amount = 10;
         jump_state = false;
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <glbinding/gl/gl.h>
 
+#include "gl_primitives/gl_primitives.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+
 using namespace gl;
 
 class Rectangle
@@ -11,9 +14,9 @@ public:
     Rectangle(int rectangle_width, int rectangle_height, int rectangle_pos_x,
               int rectangle_pos_y);
 
-    ~Rectangle();
+    ~Rectangle() = default;
 
-    void draw(unsigned int shader_program, float r, float g, float b);
+    void draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g, float b);
 
     void jump();
 
@@ -24,3 +27,6 @@ public:
     bool jump_state = false;
     int jump_amount = 10;
 };
+
+// one tick of a jump in progress, Rectangle::jump and replayed ghosts both go through this
+void apply_jump(int& pos_y, int& jump_amount, bool& jump_state);
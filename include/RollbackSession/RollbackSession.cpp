@@ -0,0 +1,226 @@
+#include "RollbackSession.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+namespace
+{
+    constexpr std::uint32_t input_packet_magic = 0x524A4C47; // "GLJR"
+    constexpr std::uint32_t max_packet_inputs = 64;
+}
+
+RollbackSession::RollbackSession(const Level& level, unsigned int screen_width, int local_player,
+                                 UdpSocket& socket)
+        : m_level(level),
+          m_screen_width(screen_width),
+          m_local_player(local_player),
+          m_socket(socket)
+{
+    m_state.players[0] = make_game_state(level, screen_width);
+    m_state.players[1] = m_state.players[0];
+}
+
+bool RollbackSession::advance(bool local_space, game_events& local_events)
+{
+    poll();
+    if (!m_connected)
+    {
+        // keep saying hello until the peer answers
+        send_inputs();
+        return false;
+    }
+    if (m_rollback_from < m_tick)
+    {
+        rollback();
+    }
+
+    /*
+     * wait for the peer when we'd have to predict too far, or when we're
+     * clearly further ahead of it than it is of us, so neither side keeps
+     * rolling back because the other started later. A couple of ticks of
+     * slack keeps jitter from stalling both sides in turn
+     */
+    int local_advantage = static_cast<int>(m_tick) - static_cast<int>(m_remote_tick);
+    int remote_advantage = static_cast<int>(m_remote_tick) - static_cast<int>(m_remote_ack);
+    if (m_tick >= m_remote_confirmed + max_prediction || (local_advantage - remote_advantage) / 2 >= 2)
+    {
+        m_stalls++;
+        send_inputs();
+        return false;
+    }
+
+    m_local_inputs[m_tick % history_size] = local_space;
+    simulate_tick(&local_events);
+    send_inputs();
+    check_desync();
+    return true;
+}
+
+const GameState& RollbackSession::get_local() const
+{
+    return m_state.players[m_local_player];
+}
+
+const GameState& RollbackSession::get_remote() const
+{
+    return m_state.players[1 - m_local_player];
+}
+
+bool RollbackSession::is_connected() const
+{
+    return m_connected;
+}
+
+std::uint32_t RollbackSession::get_tick() const
+{
+    return m_tick;
+}
+
+void RollbackSession::print_stats() const
+{
+    using milliseconds = std::chrono::duration<double, std::milli>;
+    std::cout << "race: " << m_tick << " ticks, " << m_stalls << " stalls, " << m_socket.get_sent()
+              << " packets sent (" << m_socket.get_dropped() << " dropped), " << m_packets_received
+              << " received" << std::endl;
+    std::cout << "race: " << m_rollbacks << " rollbacks, " << m_resimulated_ticks << " ticks re-simulated, "
+              << "deepest " << m_max_rollback_depth << " ticks, re-sim "
+              << (m_rollbacks ? milliseconds(m_resim_time).count() / m_rollbacks : 0.0) << " ms average, "
+              << milliseconds(m_max_resim_time).count() << " ms worst" << std::endl;
+}
+
+void RollbackSession::poll()
+{
+    std::array<std::byte, UdpSocket::max_datagram_size> buffer;
+    while (std::size_t size = m_socket.receive(buffer))
+    {
+        m_input_packet packet;
+        if (size != sizeof(packet))
+        {
+            continue;
+        }
+        std::memcpy(&packet, buffer.data(), sizeof(packet));
+        if (packet.magic != input_packet_magic || packet.count > max_packet_inputs)
+        {
+            continue;
+        }
+        m_packets_received++;
+        m_connected = true;
+        receive_packet(packet);
+    }
+}
+
+void RollbackSession::receive_packet(const m_input_packet& packet)
+{
+    m_remote_tick = std::max(m_remote_tick, packet.first_tick + packet.count);
+    m_remote_ack = std::max(m_remote_ack, packet.ack);
+
+    for (std::uint32_t i = 0; i < packet.count; i++)
+    {
+        std::uint32_t tick = packet.first_tick + i;
+        if (tick < m_remote_confirmed || tick >= m_remote_confirmed + history_size)
+        {
+            continue;
+        }
+        std::uint32_t slot = tick % history_size;
+        if (m_remote_known[slot])
+        {
+            continue;
+        }
+        std::uint8_t input = (packet.inputs >> i) & 1;
+        m_remote_known[slot] = 1;
+        m_remote_inputs[slot] = input;
+        // already simulated with a guess that turned out wrong
+        if (tick < m_tick && input != m_remote_used[slot])
+        {
+            m_rollback_from = std::min(m_rollback_from, tick);
+        }
+    }
+
+    while (m_remote_known[m_remote_confirmed % history_size])
+    {
+        m_remote_known[m_remote_confirmed % history_size] = 0;
+        m_remote_confirmed++;
+    }
+}
+
+void RollbackSession::rollback()
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::uint32_t end_tick = m_tick;
+    m_state = m_snapshots[m_rollback_from % history_size];
+    m_tick = m_rollback_from;
+    while (m_tick < end_tick)
+    {
+        // effects of the replayed ticks were shown already
+        simulate_tick(nullptr);
+    }
+
+    auto elapsed = std::chrono::steady_clock::now() - start;
+    m_rollbacks++;
+    m_resimulated_ticks += end_tick - m_rollback_from;
+    m_max_rollback_depth = std::max(m_max_rollback_depth, end_tick - m_rollback_from);
+    m_resim_time += elapsed;
+    m_max_resim_time = std::max(m_max_resim_time, elapsed);
+    m_rollback_from = UINT32_MAX;
+}
+
+void RollbackSession::simulate_tick(game_events* local_events)
+{
+    std::uint32_t slot = m_tick % history_size;
+    m_snapshots[slot] = m_state;
+
+    bool remote_input = get_remote_input(m_tick);
+    m_remote_used[slot] = remote_input;
+
+    game_events events = step_game(m_state.players[m_local_player], m_local_inputs[slot], m_level,
+                                   m_screen_width);
+    step_game(m_state.players[1 - m_local_player], remote_input, m_level, m_screen_width);
+    if (local_events)
+    {
+        *local_events = events;
+    }
+    m_tick++;
+}
+
+bool RollbackSession::get_remote_input(std::uint32_t tick) const
+{
+    if (tick < m_remote_confirmed || m_remote_known[tick % history_size])
+    {
+        return m_remote_inputs[tick % history_size];
+    }
+    // predict the peer keeps doing what it did last
+    return m_remote_confirmed > 0 && m_remote_inputs[(m_remote_confirmed - 1) % history_size];
+}
+
+void RollbackSession::send_inputs()
+{
+    m_input_packet packet{};
+    packet.magic = input_packet_magic;
+    packet.count = std::min(m_tick, max_packet_inputs);
+    packet.first_tick = m_tick - packet.count;
+    packet.ack = m_remote_confirmed;
+    for (std::uint32_t i = 0; i < packet.count; i++)
+    {
+        packet.inputs |= static_cast<std::uint64_t>(m_local_inputs[(packet.first_tick + i) % history_size]) << i;
+    }
+
+    std::array<std::byte, sizeof(packet)> datagram;
+    std::memcpy(datagram.data(), &packet, sizeof(packet));
+    m_socket.send(datagram);
+}
+
+void RollbackSession::check_desync()
+{
+    // once every input before a tick is known its snapshot is final, both sides print the same hash
+    while (m_next_checksum_tick <= m_remote_confirmed && m_next_checksum_tick < m_tick)
+    {
+        const RaceState& state = m_snapshots[m_next_checksum_tick % history_size];
+        std::uint64_t hash = hash_game_state(state.players[0]) * 31 + hash_game_state(state.players[1]);
+        log_info("RACE", "tick {} checksum {:x}", m_next_checksum_tick, hash);
+        m_next_checksum_tick += 600;
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "GameState/GameState.h"
+#include "Level/Level.h"
+#include "UdpSocket/UdpSocket.h"
+
+// both players of a race, indexed by player number
+struct RaceState
+{
+    std::array<GameState, 2> players;
+};
+
+/*
+ * Two player race with rollback. Only inputs cross the network; every
+ * packet repeats the sender's last 64 ticks of space bits, so a lost packet
+ * is covered by the next one. The remote input for ticks not yet received
+ * is predicted as its last confirmed value. When a real input turns out to
+ * differ from the prediction, the state snapshot from before that tick is
+ * restored and every tick since is simulated again. A snapshot is a plain
+ * copy of RaceState, saved once per tick into a fixed ring.
+ *
+ * Both machines must run the same binary, the packets are in host byte order.
+ */
+class RollbackSession
+{
+public:
+    // ticks of history kept, bounds how far back a rollback can go
+    static constexpr std::uint32_t history_size = 128;
+    // ticks we may run ahead of the last confirmed remote input before waiting
+    static constexpr std::uint32_t max_prediction = 32;
+
+    RollbackSession(const Level& level, unsigned int screen_width, int local_player, UdpSocket& socket);
+
+    // reads the network, rolls back if the past changed, then simulates the next tick.
+    // returns false when the tick had to wait for the peer
+    bool advance(bool local_space, game_events& local_events);
+
+    const GameState& get_local() const;
+
+    const GameState& get_remote() const;
+
+    bool is_connected() const;
+
+    std::uint32_t get_tick() const;
+
+    void print_stats() const;
+
+private:
+    struct m_input_packet
+    {
+        std::uint32_t magic;
+        // packet carries inputs for [first_tick, first_tick + count), bit i is tick first_tick + i
+        std::uint32_t first_tick;
+        std::uint32_t count;
+        // how many of the receiver's ticks the sender has confirmed
+        std::uint32_t ack;
+        std::uint64_t inputs;
+    };
+
+    void poll();
+
+    void receive_packet(const m_input_packet& packet);
+
+    void rollback();
+
+    void simulate_tick(game_events* local_events);
+
+    bool get_remote_input(std::uint32_t tick) const;
+
+    void send_inputs();
+
+    void check_desync();
+
+    const Level& m_level;
+    unsigned int m_screen_width;
+    int m_local_player;
+    UdpSocket& m_socket;
+
+    RaceState m_state;
+    std::uint32_t m_tick = 0;
+    bool m_connected = false;
+
+    // m_snapshots[t % history_size] is the state right before tick t
+    std::array<RaceState, history_size> m_snapshots;
+    std::array<std::uint8_t, history_size> m_local_inputs{};
+    std::array<std::uint8_t, history_size> m_remote_inputs{};
+    // remote inputs that arrived ahead of a gap, at or after m_remote_confirmed
+    std::array<std::uint8_t, history_size> m_remote_known{};
+    // remote input the last simulation of each tick went with
+    std::array<std::uint8_t, history_size> m_remote_used{};
+    // every remote input before this tick is known
+    std::uint32_t m_remote_confirmed = 0;
+    // next tick the peer simulates, as of its latest packet
+    std::uint32_t m_remote_tick = 0;
+    // how many of our ticks the peer has confirmed
+    std::uint32_t m_remote_ack = 0;
+    std::uint32_t m_rollback_from = UINT32_MAX;
+    std::uint32_t m_next_checksum_tick = 600;
+
+    std::uint64_t m_packets_received = 0;
+    std::uint64_t m_rollbacks = 0;
+    std::uint64_t m_resimulated_ticks = 0;
+    std::uint32_t m_max_rollback_depth = 0;
+    std::uint64_t m_stalls = 0;
+    std::chrono::steady_clock::duration m_resim_time{};
+    std::chrono::steady_clock::duration m_max_resim_time{};
+};
@@ -0,0 +1,236 @@
+#include "ScriptRunner.h"
+
+#include <algorithm>
+#include <exception>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+void script::promise_type::operator delete(void* frame, std::size_t) noexcept
+{
+    auto* header = static_cast<ScriptRunner::m_frame_header*>(frame) - 1;
+    header->runner->free_frame(frame);
+}
+
+void script::promise_type::unhandled_exception()
+{
+    log_error("SCRIPT", "a script threw");
+    get_logger().flush();
+    std::terminate();
+}
+
+script::~script()
+{
+    // never started, the frame goes straight back to the pool
+    if (m_handle)
+    {
+        m_handle.destroy();
+    }
+}
+
+script::script(script&& other) noexcept
+        : m_handle(other.m_handle)
+{
+    other.m_handle = {};
+}
+
+script& script::operator=(script&& other) noexcept
+{
+    if (this != &other)
+    {
+        if (m_handle)
+        {
+            m_handle.destroy();
+        }
+        m_handle = other.m_handle;
+        other.m_handle = {};
+    }
+    return *this;
+}
+
+void* script::allocate_frame(ScriptRunner& runner, std::size_t size)
+{
+    return runner.allocate_frame(size);
+}
+
+void wait_ticks::await_suspend(std::coroutine_handle<script::promise_type> handle) const
+{
+    ScriptRunner& runner = *handle.promise().runner;
+    runner.m_timers->schedule(runner.m_timers->get_now() + ticks, runner.get_slot(handle));
+}
+
+void until_input::await_suspend(std::coroutine_handle<script::promise_type> handle) const
+{
+    ScriptRunner& runner = *handle.promise().runner;
+    runner.m_input_waiters.push_back(runner.get_slot(handle));
+}
+
+void until_collision::await_suspend(std::coroutine_handle<script::promise_type> handle) const
+{
+    ScriptRunner& runner = *handle.promise().runner;
+    runner.m_collision_waiters.push_back(runner.get_slot(handle));
+}
+
+ScriptRunner::ScriptRunner(std::size_t frame_size)
+        : m_block_size((sizeof(m_frame_header) + frame_size + alignof(m_frame_header) - 1) /
+                       alignof(m_frame_header) * alignof(m_frame_header)),
+          m_frames(new std::byte[m_block_size * capacity]),
+          m_handles(capacity),
+          m_timers(std::make_unique<TimingWheel<std::uint16_t, capacity>>())
+{
+    // handed out lowest block first
+    m_free_blocks.reserve(capacity);
+    for (std::size_t block = capacity; block > 0; block--)
+    {
+        m_free_blocks.push_back(static_cast<std::uint16_t>(block - 1));
+    }
+    // a slot waits on one thing at a time, no list can outgrow the pool
+    m_input_waiters.reserve(capacity);
+    m_collision_waiters.reserve(capacity);
+    m_waking_input.reserve(capacity);
+    m_waking_collision.reserve(capacity);
+}
+
+ScriptRunner::~ScriptRunner()
+{
+    stop_all();
+}
+
+bool ScriptRunner::start(script new_script)
+{
+    if (!new_script)
+    {
+        log_error("SCRIPT", "Failed to start a script, no frame for it");
+        return false;
+    }
+    // a script that named another runner has its frame in that runner's pool, it has no slot here
+    auto* frame = static_cast<std::byte*>(new_script.m_handle.address());
+    if (frame < m_frames.get() || frame >= m_frames.get() + m_block_size * capacity)
+    {
+        log_error("SCRIPT", "Failed to start a script, its frame belongs to another runner");
+        return false;
+    }
+    std::uint16_t slot = get_slot(new_script.m_handle);
+    m_handles[slot] = new_script.m_handle;
+    new_script.m_handle = {};
+    m_running++;
+    m_most_running = std::max(m_most_running, m_running);
+    resume(slot);
+    return true;
+}
+
+void ScriptRunner::tick(const script_input& input)
+{
+    if (input.pressed)
+    {
+        m_waking_input.swap(m_input_waiters);
+    }
+    if (input.collided)
+    {
+        m_waking_collision.swap(m_collision_waiters);
+    }
+    m_timers->advance([&](std::span<const std::uint16_t> slots)
+                      {
+                          for (std::uint16_t slot: slots)
+                          {
+                              resume(slot);
+                          }
+                      });
+    resume_all(m_waking_input);
+    resume_all(m_waking_collision);
+}
+
+void ScriptRunner::stop_all()
+{
+    m_timers->clear();
+    m_input_waiters.clear();
+    m_collision_waiters.clear();
+    m_waking_input.clear();
+    m_waking_collision.clear();
+    for (auto& handle: m_handles)
+    {
+        if (handle)
+        {
+            // clears the slot first, destroy hands the block back through free_frame
+            std::coroutine_handle<script::promise_type> stopped = handle;
+            handle = {};
+            stopped.destroy();
+        }
+    }
+    m_running = 0;
+}
+
+std::size_t ScriptRunner::get_running() const
+{
+    return m_running;
+}
+
+std::size_t ScriptRunner::get_timed() const
+{
+    return m_timers->get_pending();
+}
+
+void ScriptRunner::print_report() const
+{
+    std::cout << "scripts: " << m_most_running << " at most running, " << m_resumes << " resumes, largest frame "
+              << m_largest_frame << " of " << m_block_size - sizeof(m_frame_header) << " bytes";
+    if (m_failed_frames > 0)
+    {
+        std::cout << ", " << m_failed_frames << " failed to get a frame";
+    }
+    std::cout << std::endl;
+}
+
+void* ScriptRunner::allocate_frame(std::size_t size)
+{
+    if (size + sizeof(m_frame_header) > m_block_size || m_free_blocks.empty())
+    {
+        m_failed_frames++;
+        return nullptr;
+    }
+    m_largest_frame = std::max(m_largest_frame, size);
+    std::uint16_t block = m_free_blocks.back();
+    m_free_blocks.pop_back();
+    auto* header = reinterpret_cast<m_frame_header*>(m_frames.get() + block * m_block_size);
+    header->runner = this;
+    return header + 1;
+}
+
+void ScriptRunner::free_frame(void* frame)
+{
+    auto offset = static_cast<std::size_t>(static_cast<std::byte*>(frame) - m_frames.get());
+    m_free_blocks.push_back(static_cast<std::uint16_t>(offset / m_block_size));
+}
+
+std::uint16_t ScriptRunner::get_slot(std::coroutine_handle<script::promise_type> handle) const
+{
+    // the frame lives somewhere in its block, whatever the compiler puts at its address
+    auto offset = static_cast<std::size_t>(static_cast<std::byte*>(handle.address()) - m_frames.get());
+    return static_cast<std::uint16_t>(offset / m_block_size);
+}
+
+void ScriptRunner::resume(std::uint16_t slot)
+{
+    std::coroutine_handle<script::promise_type> handle = m_handles[slot];
+    if (!handle)
+    {
+        return;
+    }
+    m_resumes++;
+    handle.resume();
+    if (handle.done())
+    {
+        m_handles[slot] = {};
+        m_running--;
+        handle.destroy();
+    }
+}
+
+void ScriptRunner::resume_all(std::vector<std::uint16_t>& slots)
+{
+    for (std::uint16_t slot: slots)
+    {
+        resume(slot);
+    }
+    slots.clear();
+}
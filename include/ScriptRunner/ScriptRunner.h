@@ -0,0 +1,260 @@
+#pragma once
+
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "TimingWheel/TimingWheel.h"
+
+class ScriptRunner;
+
+/*
+ * A coroutine run a tick at a time by a ScriptRunner. Script functions
+ * take the runner as their first parameter, their frames come out of its
+ * pool through promise_type::operator new, never from the heap:
+ *
+ *   script blink([[maybe_unused]] ScriptRunner& runner, bool& on)
+ *   {
+ *       for (int i = 0; i < 6; i++)
+ *       {
+ *           on = !on;
+ *           co_await wait_ticks{8};
+ *       }
+ *   }
+ *
+ *   runner.start(blink(runner, on));
+ *
+ * Nothing runs until the script is started. When the pool is out of
+ * blocks, or the frame doesn't fit in one, the call returns an empty
+ * script and start refuses it.
+ */
+class script
+{
+public:
+    struct promise_type
+    {
+        template<typename... Args>
+        explicit promise_type(ScriptRunner& runner, Args&...)
+                : runner(&runner)
+        {
+        }
+
+        // newer GCCs pair this with the sized operator delete below and warn, but a coroutine frame is always
+        // freed through that one, the runner is found again in the frame's header
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+        template<typename... Args>
+        static void* operator new(std::size_t size, ScriptRunner& runner, Args&...) noexcept
+        {
+            return allocate_frame(runner, size);
+        }
+
+        // a script has to name its runner, there's no pool to come from otherwise
+        static void* operator new(std::size_t size) = delete;
+
+        static void operator delete(void* frame, std::size_t size) noexcept;
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+
+        static script get_return_object_on_allocation_failure()
+        {
+            return script();
+        }
+
+        script get_return_object()
+        {
+            return script(std::coroutine_handle<promise_type>::from_promise(*this));
+        }
+
+        std::suspend_always initial_suspend() noexcept
+        {
+            return {};
+        }
+
+        // the runner sees done() and destroys the frame
+        std::suspend_always final_suspend() noexcept
+        {
+            return {};
+        }
+
+        void return_void()
+        {
+        }
+
+        void unhandled_exception();
+
+        ScriptRunner* runner;
+    };
+
+    script() = default;
+
+    ~script();
+
+    script(script&& other) noexcept;
+
+    script& operator=(script&& other) noexcept;
+
+    script(const script&) = delete;
+
+    script& operator=(const script&) = delete;
+
+    explicit operator bool() const
+    {
+        return static_cast<bool>(m_handle);
+    }
+
+private:
+    friend class ScriptRunner;
+
+    explicit script(std::coroutine_handle<promise_type> handle)
+            : m_handle(handle)
+    {
+    }
+
+    static void* allocate_frame(ScriptRunner& runner, std::size_t size);
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// co_await wait_ticks{n} resumes n ticks later, wait_ticks{0} doesn't suspend
+struct wait_ticks
+{
+    std::uint32_t ticks;
+
+    bool await_ready() const noexcept
+    {
+        return ticks == 0;
+    }
+
+    void await_suspend(std::coroutine_handle<script::promise_type> handle) const;
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+inline wait_ticks next_tick()
+{
+    return {1};
+}
+
+// resumes on a later tick with a fresh press
+struct until_input
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<script::promise_type> handle) const;
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+// resumes on a later tick on which the player collides
+struct until_collision
+{
+    bool await_ready() const noexcept
+    {
+        return false;
+    }
+
+    void await_suspend(std::coroutine_handle<script::promise_type> handle) const;
+
+    void await_resume() const noexcept
+    {
+    }
+};
+
+// what happened on a tick, for the scripts waiting on it
+struct script_input
+{
+    bool pressed = false;
+    bool collided = false;
+};
+
+/*
+ * Runs scripts a tick at a time. Every script has a block of a pool
+ * allocated up front and sleeps on one thing: tick waits sit on a
+ * TimingWheel, input and collision waits on lists that are only walked
+ * when their event happens. A tick costs the wheel's advance plus a
+ * resume per script that wakes, however many are waiting, and nothing
+ * touches the heap after construction.
+ */
+class ScriptRunner
+{
+public:
+    static constexpr std::size_t capacity = 4096;
+
+    // frame_size is the largest frame a script may have: its parameters, locals and what the compiler adds
+    explicit ScriptRunner(std::size_t frame_size = 256);
+
+    ~ScriptRunner();
+
+    ScriptRunner(const ScriptRunner&) = delete;
+
+    ScriptRunner& operator=(const ScriptRunner&) = delete;
+
+    // runs the script up to its first co_await, false for an empty one or one with another runner's frame
+    bool start(script new_script);
+
+    void tick(const script_input& input);
+
+    // destroys every script where it waits
+    void stop_all();
+
+    std::size_t get_running() const;
+
+    // scripts waiting on ticks, the ones that change something without any input
+    std::size_t get_timed() const;
+
+    void print_report() const;
+
+private:
+    friend class script;
+    friend struct wait_ticks;
+    friend struct until_input;
+    friend struct until_collision;
+
+    // in front of every frame, so operator delete finds the pool
+    struct alignas(__STDCPP_DEFAULT_NEW_ALIGNMENT__) m_frame_header
+    {
+        ScriptRunner* runner;
+    };
+
+    void* allocate_frame(std::size_t size);
+
+    void free_frame(void* frame);
+
+    std::uint16_t get_slot(std::coroutine_handle<script::promise_type> handle) const;
+
+    void resume(std::uint16_t slot);
+
+    void resume_all(std::vector<std::uint16_t>& slots);
+
+    std::size_t m_block_size;
+    std::unique_ptr<std::byte[]> m_frames;
+    std::vector<std::uint16_t> m_free_blocks;
+    // by block, empty unless the script in it was started and hasn't finished
+    std::vector<std::coroutine_handle<script::promise_type>> m_handles;
+
+    std::unique_ptr<TimingWheel<std::uint16_t, capacity>> m_timers;
+    std::vector<std::uint16_t> m_input_waiters;
+    std::vector<std::uint16_t> m_collision_waiters;
+    // a tick's waiters are swapped out before anything resumes, whatever waits again waits for the next event
+    std::vector<std::uint16_t> m_waking_input;
+    std::vector<std::uint16_t> m_waking_collision;
+
+    std::size_t m_running = 0;
+    std::size_t m_most_running = 0;
+    std::uint64_t m_resumes = 0;
+    std::uint64_t m_failed_frames = 0;
+    std::size_t m_largest_frame = 0;
+};
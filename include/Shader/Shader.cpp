@@ -1,33 +1,17 @@
 #include "Shader.h"
 
-Shader::Shader()
-{
-    m_vertex_shader_source = R"(
-        #version 330 core
-        layout (location = 0) in vec2 aPos;
-
-        uniform mat4 projection;
-
-        void main()
-        {
-            gl_Position = projection * vec4(aPos.xy, 1, 1);
-        }
-    )";
-
-    m_fragment_shader_source = R"(
-        #version 330 core
-        out vec4 FragColor;
+#include "Logger/Logger.h"
 
-        uniform vec3 color;
+Shader::Shader(const AssetPack& pack, std::string_view name)
+        : Shader(ShaderSource::load(pack, name))
+{
 
-        void main()
-        {
-            FragColor = vec4(color.xyz, 1.0f);
-        }
-    )";
+}
 
-    m_shader_program = create_shader_program(m_vertex_shader_source,
-                                             m_fragment_shader_source);
+Shader::Shader(const ShaderSource& source)
+{
+    m_shader_program = gl_program::adopt(create_shader_program(source.get_vertex(), source.get_fragment()),
+                                         "Shader");
 }
 
 Shader::~Shader()
@@ -37,16 +21,18 @@ Shader::~Shader()
 
 unsigned int Shader::get_shader_program()
 {
-    return m_shader_program;
+    return m_shader_program.get();
 }
 
-unsigned int Shader::create_shader_program(const std::string& vertex_source,
-                                           const std::string& fragment_source)
+unsigned int Shader::create_shader_program(std::string_view vertex_source,
+                                           std::string_view fragment_source)
 {
     // vertex shader
     unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const char* c_str_vertex = vertex_source.c_str();
-    glShaderSource(vertexShader, 1, &c_str_vertex, nullptr);
+    // sources may point straight into the asset pack and aren't NUL terminated
+    const char* c_str_vertex = vertex_source.data();
+    GLint vertex_length = static_cast<GLint>(vertex_source.size());
+    glShaderSource(vertexShader, 1, &c_str_vertex, &vertex_length);
     glCompileShader(vertexShader);
     // check for shader compile errors
     int success;
@@ -55,21 +41,20 @@ unsigned int Shader::create_shader_program(const std::string& vertex_source,
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog
-                  << std::endl;
+        log_error("SHADER::VERTEX::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // fragment shader
     unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* c_str_fragment = fragment_source.c_str();
-    glShaderSource(fragmentShader, 1, &c_str_fragment, nullptr);
+    const char* c_str_fragment = fragment_source.data();
+    GLint fragment_length = static_cast<GLint>(fragment_source.size());
+    glShaderSource(fragmentShader, 1, &c_str_fragment, &fragment_length);
     glCompileShader(fragmentShader);
     // check for shader compile errors
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog
-                  << std::endl;
+        log_error("SHADER::FRAGMENT::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // link shaders
     unsigned int shaderProgram = glCreateProgram();
@@ -81,8 +66,7 @@ unsigned int Shader::create_shader_program(const std::string& vertex_source,
     if (!success)
     {
         glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog
-                  << std::endl;
+        log_error("SHADER::PROGRAM::LINKING_FAILED", "\n{}", infoLog);
     }
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
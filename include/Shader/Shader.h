@@ -1,24 +1,31 @@
 #pragma once
 
 #include <iostream>
+#include <string_view>
 #include <glbinding/gl/gl.h>
 
+#include "AssetPack/AssetPack.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_resources/gl_resources.h"
+
 using namespace gl;
 
 class Shader
 {
 public:
-    Shader();
+    // builds shaders/<name>.vert and shaders/<name>.frag from the pack
+    Shader(const AssetPack& pack, std::string_view name);
+
+    // compiles a source that was loaded ahead of time
+    explicit Shader(const ShaderSource& source);
 
     ~Shader();
 
     unsigned int get_shader_program();
 
 private:
-    unsigned int create_shader_program(const std::string& vertex_source,
-                                       const std::string& fragment_source);
+    unsigned int create_shader_program(std::string_view vertex_source,
+                                       std::string_view fragment_source);
 
-    unsigned int m_shader_program;
-    std::string m_vertex_shader_source;
-    std::string m_fragment_shader_source;
+    gl_program m_shader_program;
 };
@@ -0,0 +1,59 @@
+#include "ShaderSource.h"
+
+#include "Logger/Logger.h"
+
+ShaderSource ShaderSource::load(const AssetPack& pack, std::string_view name)
+{
+    std::string path = "shaders/" + std::string(name);
+    ShaderSource source;
+    source.m_vertex = preprocess(pack, pack.get_text(path + ".vert"), source.m_vertex_storage);
+    source.m_fragment = preprocess(pack, pack.get_text(path + ".frag"), source.m_fragment_storage);
+    return source;
+}
+
+std::string_view ShaderSource::get_vertex() const
+{
+    // storage is only used when includes had to be pasted in
+    return m_vertex_storage.empty() ? m_vertex : m_vertex_storage;
+}
+
+std::string_view ShaderSource::get_fragment() const
+{
+    return m_fragment_storage.empty() ? m_fragment : m_fragment_storage;
+}
+
+std::string_view ShaderSource::preprocess(const AssetPack& pack, std::string_view source, std::string& storage)
+{
+    constexpr std::string_view directive = "#include \"";
+    if (source.find(directive) == std::string_view::npos)
+    {
+        return source;
+    }
+
+    // included files are pasted in place, they don't include anything themselves
+    std::size_t line_begin = 0;
+    while (line_begin < source.size())
+    {
+        std::size_t line_end = source.find('\n', line_begin);
+        line_end = line_end == std::string_view::npos ? source.size() : line_end + 1;
+        std::string_view line = source.substr(line_begin, line_end - line_begin);
+
+        std::size_t name_end = line.find('"', directive.size());
+        if (line.starts_with(directive) && name_end != std::string_view::npos)
+        {
+            std::string include = "shaders/" + std::string(line.substr(directive.size(), name_end - directive.size()));
+            std::string_view text = pack.get_text(include);
+            if (text.empty())
+            {
+                log_error("SHADER::PREPROCESS", "missing include {}", include);
+            }
+            storage += text;
+            storage += '\n';
+        } else
+        {
+            storage += line;
+        }
+        line_begin = line_end;
+    }
+    return {};
+}
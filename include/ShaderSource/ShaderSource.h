@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "AssetPack/AssetPack.h"
+
+/*
+ * Vertex and fragment source of one program, ready for glShaderSource.
+ * Loading resolves #include "file" lines against shaders/ in the pack.
+ * This is CPU only work, so it can run on any thread before the GL
+ * context exists. Sources without includes stay views into the pack.
+ */
+class ShaderSource
+{
+public:
+    ShaderSource() = default;
+
+    // shaders/<name>.vert and shaders/<name>.frag
+    static ShaderSource load(const AssetPack& pack, std::string_view name);
+
+    std::string_view get_vertex() const;
+
+    std::string_view get_fragment() const;
+
+private:
+    // returns the source itself, or fills storage when it has includes
+    static std::string_view preprocess(const AssetPack& pack, std::string_view source, std::string& storage);
+
+    std::string_view m_vertex;
+    std::string_view m_fragment;
+    std::string m_vertex_storage;
+    std::string m_fragment_storage;
+};
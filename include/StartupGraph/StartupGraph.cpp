@@ -0,0 +1,128 @@
+#include "StartupGraph.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+StartupGraph::StartupGraph(unsigned int thread_count)
+        : m_thread_count(thread_count == 0 ? 1 : thread_count)
+{
+
+}
+
+StartupGraph::~StartupGraph()
+{
+    if (m_workers.empty())
+    {
+        return;
+    }
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_task_done.wait(lock, [&] { return m_remaining == 0; });
+    }
+    m_task_ready.notify_all();
+    for (std::thread& worker: m_workers)
+    {
+        worker.join();
+    }
+}
+
+StartupGraph::task_id StartupGraph::add_task(std::string_view name, std::function<void()> work,
+                                             std::initializer_list<task_id> dependencies)
+{
+    task_id id = m_tasks.size();
+    m_task task;
+    task.name = name;
+    task.work = std::move(work);
+    task.pending_dependencies = dependencies.size();
+    m_tasks.push_back(std::move(task));
+    for (task_id dependency: dependencies)
+    {
+        m_tasks[dependency].dependents.push_back(id);
+    }
+    if (dependencies.size() == 0)
+    {
+        m_ready.push_back(id);
+    }
+    m_remaining++;
+    return id;
+}
+
+void StartupGraph::start()
+{
+    unsigned int workers = std::min<std::size_t>(m_thread_count, m_tasks.size());
+    for (unsigned int i = 0; i < workers; i++)
+    {
+        m_workers.emplace_back(&StartupGraph::worker_loop, this, i);
+    }
+}
+
+void StartupGraph::wait(task_id task)
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_task_done.wait(lock, [&] { return m_tasks[task].done; });
+}
+
+void StartupGraph::record(std::string_view name, clock::time_point begin)
+{
+    clock::time_point end = clock::now();
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_events.push_back({std::string(name), "main", begin, end});
+}
+
+void StartupGraph::print_timeline()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    std::sort(m_events.begin(), m_events.end(), [](const m_event& a, const m_event& b)
+    {
+        return a.begin < b.begin;
+    });
+    auto milliseconds = [&](clock::time_point time)
+    {
+        return std::chrono::duration<double, std::milli>(time - m_start).count();
+    };
+    std::cout << "startup timeline (ms)" << std::endl;
+    for (const m_event& event: m_events)
+    {
+        std::cout << std::fixed << std::setprecision(2)
+                  << std::setw(9) << milliseconds(event.begin) << " - "
+                  << std::setw(9) << milliseconds(event.end) << "  "
+                  << std::left << std::setw(10) << event.thread << std::right
+                  << event.name << std::endl;
+    }
+}
+
+void StartupGraph::worker_loop(unsigned int index)
+{
+    std::string thread_name = "worker " + std::to_string(index);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    while (true)
+    {
+        m_task_ready.wait(lock, [&] { return !m_ready.empty() || m_remaining == 0; });
+        if (m_ready.empty())
+        {
+            return;
+        }
+        task_id id = m_ready.back();
+        m_ready.pop_back();
+
+        lock.unlock();
+        clock::time_point begin = clock::now();
+        m_tasks[id].work();
+        clock::time_point end = clock::now();
+        lock.lock();
+
+        m_events.push_back({m_tasks[id].name, thread_name, begin, end});
+        m_tasks[id].done = true;
+        m_remaining--;
+        for (task_id dependent: m_tasks[id].dependents)
+        {
+            if (--m_tasks[dependent].pending_dependencies == 0)
+            {
+                m_ready.push_back(dependent);
+            }
+        }
+        m_task_ready.notify_all();
+        m_task_done.notify_all();
+    }
+}
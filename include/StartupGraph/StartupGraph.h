@@ -0,0 +1,77 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <initializer_list>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+/*
+ * Runs the CPU only part of startup (asset parsing, font rasterization,
+ * shader preprocessing, level generation) on worker threads while the
+ * main thread brings up the window and GL context.
+ * Every task and every main thread step is put on one timeline, so time
+ * to first frame can be broken down with print_timeline().
+ */
+class StartupGraph
+{
+public:
+    using clock = std::chrono::steady_clock;
+    using task_id = std::size_t;
+
+    explicit StartupGraph(unsigned int thread_count);
+
+    // waits for every task
+    ~StartupGraph();
+
+    // tasks can only be added before start(), dependencies must already exist
+    task_id add_task(std::string_view name, std::function<void()> work,
+                     std::initializer_list<task_id> dependencies = {});
+
+    void start();
+
+    // blocks until the task has run
+    void wait(task_id task);
+
+    // puts work the main thread did since begin on the timeline
+    void record(std::string_view name, clock::time_point begin);
+
+    void print_timeline();
+
+private:
+    struct m_task
+    {
+        std::string name;
+        std::function<void()> work;
+        std::vector<task_id> dependents;
+        std::size_t pending_dependencies = 0;
+        bool done = false;
+    };
+
+    struct m_event
+    {
+        std::string name;
+        std::string thread;
+        clock::time_point begin;
+        clock::time_point end;
+    };
+
+    void worker_loop(unsigned int index);
+
+    std::vector<m_task> m_tasks;
+    std::vector<task_id> m_ready;
+    std::vector<m_event> m_events;
+    std::vector<std::thread> m_workers;
+    unsigned int m_thread_count;
+    std::size_t m_remaining = 0;
+    clock::time_point m_start = clock::now();
+
+    std::mutex m_mutex;
+    std::condition_variable m_task_ready;
+    std::condition_variable m_task_done;
+};
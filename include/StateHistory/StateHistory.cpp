@@ -0,0 +1,278 @@
+#include "StateHistory.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+static_assert(sizeof(GameState) % sizeof(std::uint32_t) == 0);
+static_assert(sizeof(GameState) / sizeof(std::uint32_t) <= 64, "the changed word mask is 64 bits");
+
+namespace
+{
+    std::size_t write_varint(std::uint64_t value, std::uint8_t* out)
+    {
+        std::size_t size = 0;
+        while (value >= 0x80)
+        {
+            out[size++] = static_cast<std::uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<std::uint8_t>(value);
+        return size;
+    }
+
+    std::size_t read_varint(const std::uint8_t* in, std::uint64_t& value)
+    {
+        std::size_t size = 0;
+        int shift = 0;
+        value = 0;
+        std::uint8_t byte;
+        do
+        {
+            byte = in[size++];
+            value |= static_cast<std::uint64_t>(byte & 0x7F) << shift;
+            shift += 7;
+        } while (byte & 0x80);
+        return size;
+    }
+}
+
+StateHistory::StateHistory(std::size_t budget_bytes, std::uint32_t keyframe_interval)
+        : m_keyframe_interval(std::max(keyframe_interval, 1u))
+{
+    // the segment being written must fit next to the one before it, whatever the deltas compress to
+    m_budget = std::max(budget_bytes, 2 * (m_keyframe_interval + 1) * m_max_record_size);
+    m_bytes.reset(new std::uint8_t[m_budget]);
+    // every segment takes at least a keyframe
+    m_segment_capacity = m_budget / sizeof(GameState) + 1;
+    m_segments.reset(new m_segment[m_segment_capacity]);
+}
+
+void StateHistory::record(const GameState& state)
+{
+    if (m_segment_count == 0 || state.tick != get_last_tick() + 1)
+    {
+        clear();
+        start_segment(state);
+        return;
+    }
+    if (get_segment(m_segment_count - 1).tick_count == m_keyframe_interval)
+    {
+        start_segment(state);
+        return;
+    }
+
+    make_room(true);
+    std::size_t size = write_delta(state, m_bytes.get() + m_write_offset);
+    m_write_offset = wrap_offset(m_write_offset + size);
+    get_segment(m_segment_count - 1).tick_count++;
+    m_last = state;
+}
+
+bool StateHistory::seek(std::uint32_t tick, GameState& state)
+{
+    if (empty() || tick < get_first_tick() || tick > get_last_tick())
+    {
+        return false;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    const m_segment& segment = get_segment((tick - get_first_tick()) / m_keyframe_interval);
+    std::uint32_t words[m_words];
+    std::memcpy(words, m_bytes.get() + segment.begin, sizeof(GameState));
+    std::size_t offset = wrap_offset(segment.begin + sizeof(GameState));
+    for (std::uint32_t i = segment.first_tick; i < tick; i++)
+    {
+        offset = wrap_offset(offset + read_delta(m_bytes.get() + offset, words));
+    }
+    std::memcpy(&state, words, sizeof(GameState));
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    m_seeks++;
+    m_seek_time += elapsed;
+    m_last_seek_time = elapsed;
+    m_max_seek_time = std::max(m_max_seek_time, elapsed);
+    return true;
+}
+
+void StateHistory::truncate(std::uint32_t tick)
+{
+    if (empty() || tick >= get_last_tick())
+    {
+        return;
+    }
+    if (tick < get_first_tick())
+    {
+        clear();
+        return;
+    }
+
+    std::size_t index = (tick - get_first_tick()) / m_keyframe_interval;
+    m_segment_count = index + 1;
+    m_segment& segment = get_segment(index);
+    segment.tick_count = tick - segment.first_tick + 1;
+
+    // walk the deltas up to tick again to find where the next record goes
+    std::uint32_t words[m_words];
+    std::memcpy(words, m_bytes.get() + segment.begin, sizeof(GameState));
+    std::size_t offset = wrap_offset(segment.begin + sizeof(GameState));
+    for (std::uint32_t i = segment.first_tick; i < tick; i++)
+    {
+        offset = wrap_offset(offset + read_delta(m_bytes.get() + offset, words));
+    }
+    std::memcpy(&m_last, words, sizeof(GameState));
+    m_write_offset = offset;
+}
+
+void StateHistory::clear()
+{
+    m_first_segment = 0;
+    m_segment_count = 0;
+    m_write_offset = 0;
+}
+
+bool StateHistory::empty() const
+{
+    return m_segment_count == 0;
+}
+
+std::uint32_t StateHistory::get_first_tick() const
+{
+    return empty() ? 0 : get_segment(0).first_tick;
+}
+
+std::uint32_t StateHistory::get_last_tick() const
+{
+    if (empty())
+    {
+        return 0;
+    }
+    const m_segment& newest = get_segment(m_segment_count - 1);
+    return newest.first_tick + newest.tick_count - 1;
+}
+
+std::size_t StateHistory::get_budget_bytes() const
+{
+    return m_budget;
+}
+
+std::size_t StateHistory::get_used_bytes() const
+{
+    if (empty())
+    {
+        return 0;
+    }
+    // counts the unused ends of the ring that records skipped over
+    std::size_t oldest = get_segment(0).begin;
+    return m_write_offset > oldest ? m_write_offset - oldest : m_budget - oldest + m_write_offset;
+}
+
+std::chrono::nanoseconds StateHistory::get_last_seek_time() const
+{
+    return m_last_seek_time;
+}
+
+void StateHistory::print_report() const
+{
+    using microseconds = std::chrono::duration<double, std::micro>;
+    std::uint32_t ticks = empty() ? 0 : get_last_tick() - get_first_tick() + 1;
+    std::cout << "state history: " << get_used_bytes() << " of " << m_budget << " bytes, " << ticks << " ticks ("
+              << ticks * game_tick_seconds << " s) held, "
+              << (ticks ? static_cast<double>(get_used_bytes()) / ticks : 0.0) << " bytes/tick, keyframe every "
+              << m_keyframe_interval << " ticks" << std::endl;
+    std::cout << "state history: " << m_seeks << " seeks, "
+              << (m_seeks ? microseconds(m_seek_time).count() / m_seeks : 0.0) << " us average, "
+              << microseconds(m_max_seek_time).count() << " us worst" << std::endl;
+}
+
+std::size_t StateHistory::wrap_offset(std::size_t offset) const
+{
+    return m_budget - offset < m_max_record_size ? 0 : offset;
+}
+
+void StateHistory::make_room(bool keep_newest)
+{
+    if (!keep_newest && m_segment_count == m_segment_capacity)
+    {
+        m_first_segment = (m_first_segment + 1) % m_segment_capacity;
+        m_segment_count--;
+    }
+    // live bytes run from the oldest segment up to m_write_offset, wrapping,
+    // so only an oldest segment starting at or just after the write offset is in the way
+    while (m_segment_count > (keep_newest ? 1u : 0u))
+    {
+        std::size_t oldest = get_segment(0).begin;
+        if (oldest < m_write_offset || oldest - m_write_offset >= m_max_record_size)
+        {
+            break;
+        }
+        m_first_segment = (m_first_segment + 1) % m_segment_capacity;
+        m_segment_count--;
+    }
+    if (m_segment_count == 0)
+    {
+        m_write_offset = 0;
+    }
+}
+
+void StateHistory::start_segment(const GameState& state)
+{
+    make_room(false);
+    m_segment_count++;
+    get_segment(m_segment_count - 1) = {state.tick, 1, m_write_offset};
+    std::memcpy(m_bytes.get() + m_write_offset, &state, sizeof(GameState));
+    m_write_offset = wrap_offset(m_write_offset + sizeof(GameState));
+    m_last = state;
+}
+
+std::size_t StateHistory::write_delta(const GameState& state, std::uint8_t* out) const
+{
+    std::uint32_t previous[m_words];
+    std::uint32_t current[m_words];
+    std::memcpy(previous, &m_last, sizeof(GameState));
+    std::memcpy(current, &state, sizeof(GameState));
+
+    std::uint64_t mask = 0;
+    for (std::size_t i = 0; i < m_words; i++)
+    {
+        if (previous[i] != current[i])
+        {
+            mask |= std::uint64_t(1) << i;
+        }
+    }
+    std::size_t size = write_varint(mask, out);
+    for (std::size_t i = 0; i < m_words; i++)
+    {
+        if (mask & (std::uint64_t(1) << i))
+        {
+            size += write_varint(previous[i] ^ current[i], out + size);
+        }
+    }
+    return size;
+}
+
+std::size_t StateHistory::read_delta(const std::uint8_t* in, std::uint32_t* words)
+{
+    std::uint64_t mask;
+    std::size_t size = read_varint(in, mask);
+    for (std::size_t i = 0; i < m_words; i++)
+    {
+        if (mask & (std::uint64_t(1) << i))
+        {
+            std::uint64_t change;
+            size += read_varint(in + size, change);
+            words[i] ^= static_cast<std::uint32_t>(change);
+        }
+    }
+    return size;
+}
+
+StateHistory::m_segment& StateHistory::get_segment(std::size_t index)
+{
+    return m_segments[(m_first_segment + index) % m_segment_capacity];
+}
+
+const StateHistory::m_segment& StateHistory::get_segment(std::size_t index) const
+{
+    return m_segments[(m_first_segment + index) % m_segment_capacity];
+}
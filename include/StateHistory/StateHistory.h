@@ -0,0 +1,105 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+
+#include "GameState/GameState.h"
+
+/*
+ * Every tick of a GameState in a fixed amount of memory, for rewinding.
+ * Every keyframe_interval ticks the whole state is stored, the ticks in
+ * between as the XOR with the tick before, written as a mask of changed
+ * 32 bit words followed by those words as varints. Most ticks only move a
+ * couple of positions by a few pixels, so they take a handful of bytes.
+ *
+ * Records go into one byte ring. When it's full the oldest keyframe and
+ * its deltas are dropped, so the budget bounds memory and the history
+ * reaches back as far as the state has been compressible. Seeking decodes
+ * at most one keyframe and keyframe_interval - 1 deltas.
+ * Nothing allocates after construction.
+ */
+class StateHistory
+{
+public:
+    StateHistory(std::size_t budget_bytes, std::uint32_t keyframe_interval);
+
+    // state.tick must follow the last recorded tick, otherwise the history starts over
+    void record(const GameState& state);
+
+    // the state as recorded at tick, false when it isn't held anymore
+    bool seek(std::uint32_t tick, GameState& state);
+
+    // forgets everything recorded after tick, to resume from there
+    void truncate(std::uint32_t tick);
+
+    void clear();
+
+    bool empty() const;
+
+    std::uint32_t get_first_tick() const;
+
+    std::uint32_t get_last_tick() const;
+
+    std::size_t get_budget_bytes() const;
+
+    std::size_t get_used_bytes() const;
+
+    // duration of the last seek
+    std::chrono::nanoseconds get_last_seek_time() const;
+
+    void print_report() const;
+
+private:
+    static constexpr std::size_t m_words = sizeof(GameState) / sizeof(std::uint32_t);
+    // a varint mask plus every word as a full varint
+    static constexpr std::size_t m_max_delta_size = 10 + m_words * 5;
+    static constexpr std::size_t m_max_record_size =
+            m_max_delta_size > sizeof(GameState) ? m_max_delta_size : sizeof(GameState);
+
+    // a keyframe and the deltas after it, stored back to back in the ring.
+    // every segment but the newest holds keyframe_interval ticks
+    struct m_segment
+    {
+        std::uint32_t first_tick;
+        std::uint32_t tick_count;
+        std::size_t begin;
+    };
+
+    // records never straddle the end of the ring, the next one starts over at 0
+    // when less than the largest record would fit after offset
+    std::size_t wrap_offset(std::size_t offset) const;
+
+    // drops old segments until a record fits at m_write_offset, keeps the newest when keep_newest
+    void make_room(bool keep_newest);
+
+    void start_segment(const GameState& state);
+
+    std::size_t write_delta(const GameState& state, std::uint8_t* out) const;
+
+    static std::size_t read_delta(const std::uint8_t* in, std::uint32_t* words);
+
+    m_segment& get_segment(std::size_t index);
+
+    const m_segment& get_segment(std::size_t index) const;
+
+    std::size_t m_budget;
+    std::uint32_t m_keyframe_interval;
+
+    std::unique_ptr<std::uint8_t[]> m_bytes;
+    // live segments are m_first_segment .. + m_segment_count, wrapping
+    std::unique_ptr<m_segment[]> m_segments;
+    std::size_t m_segment_capacity;
+    std::size_t m_first_segment = 0;
+    std::size_t m_segment_count = 0;
+    std::size_t m_write_offset = 0;
+
+    // the newest recorded state, deltas are taken against it
+    GameState m_last{};
+
+    std::uint64_t m_seeks = 0;
+    std::chrono::nanoseconds m_seek_time{};
+    std::chrono::nanoseconds m_last_seek_time{};
+    std::chrono::nanoseconds m_max_seek_time{};
+};
@@ -0,0 +1,176 @@
+#include "ThreadPool.h"
+
+namespace
+{
+    constexpr std::uint64_t pack_range(std::uint32_t begin, std::uint32_t end)
+    {
+        return (static_cast<std::uint64_t>(begin) << 32) | end;
+    }
+
+    constexpr std::uint32_t range_begin(std::uint64_t bounds)
+    {
+        return static_cast<std::uint32_t>(bounds >> 32);
+    }
+
+    constexpr std::uint32_t range_end(std::uint64_t bounds)
+    {
+        return static_cast<std::uint32_t>(bounds);
+    }
+
+    // how long an idle worker polls for the next job before going to sleep,
+    // back to back jobs (e.g. environment steps) never pay for a wake up
+    constexpr int spin_iterations = 1 << 14;
+}
+
+ThreadPool::ThreadPool(unsigned int thread_count)
+        : m_thread_count(thread_count == 0 ? 1 : thread_count)
+{
+    m_ranges = std::make_unique<m_range[]>(m_thread_count);
+    // participant 0 is whoever calls parallel_for
+    for (unsigned int i = 1; i < m_thread_count; i++)
+    {
+        m_workers.emplace_back(&ThreadPool::worker_loop, this, i);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop.store(true);
+        m_generation.fetch_add(1);
+    }
+    m_wake.notify_all();
+    for (std::thread& worker: m_workers)
+    {
+        worker.join();
+    }
+}
+
+unsigned int ThreadPool::get_thread_count() const
+{
+    return m_thread_count;
+}
+
+void ThreadPool::run(std::size_t count, std::size_t grain, m_invoke_function invoke, void* context)
+{
+    m_grain = grain == 0 ? 1 : grain;
+    std::size_t chunks = (count + m_grain - 1) / m_grain;
+
+    // not worth waking anybody up
+    if (m_workers.empty() || chunks == 1)
+    {
+        invoke(context, 0, count);
+        return;
+    }
+
+    m_invoke = invoke;
+    m_context = context;
+    m_count = count;
+
+    // hand out an even slice of the chunks to every participant
+    for (unsigned int i = 0; i < m_thread_count; i++)
+    {
+        auto begin = static_cast<std::uint32_t>(chunks * i / m_thread_count);
+        auto end = static_cast<std::uint32_t>(chunks * (i + 1) / m_thread_count);
+        m_ranges[i].bounds.store(pack_range(begin, end), std::memory_order_relaxed);
+    }
+    m_finished_workers.store(0, std::memory_order_relaxed);
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_generation.fetch_add(1, std::memory_order_release);
+    }
+    m_wake.notify_all();
+
+    participate(0);
+
+    // every worker looks at every job exactly once, so none of them
+    // can still be reading this job's state when the next one is set up
+    while (m_finished_workers.load(std::memory_order_acquire) != m_workers.size())
+    {
+        std::this_thread::yield();
+    }
+}
+
+void ThreadPool::worker_loop(unsigned int index)
+{
+    std::uint64_t seen_generation = 0;
+    while (true)
+    {
+        int spins = 0;
+        while (m_generation.load(std::memory_order_acquire) == seen_generation && spins < spin_iterations)
+        {
+            spins++;
+        }
+        if (m_generation.load(std::memory_order_acquire) == seen_generation)
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&]
+            {
+                return m_generation.load(std::memory_order_acquire) != seen_generation;
+            });
+        }
+        seen_generation = m_generation.load(std::memory_order_acquire);
+        if (m_stop.load())
+        {
+            return;
+        }
+
+        participate(index);
+        m_finished_workers.fetch_add(1, std::memory_order_release);
+    }
+}
+
+void ThreadPool::participate(unsigned int index)
+{
+    std::uint32_t chunk;
+    do
+    {
+        while (pop_chunk(index, chunk))
+        {
+            std::size_t begin = chunk * m_grain;
+            std::size_t end = begin + m_grain < m_count ? begin + m_grain : m_count;
+            m_invoke(m_context, begin, end);
+        }
+    } while (steal_chunks(index));
+}
+
+bool ThreadPool::pop_chunk(unsigned int index, std::uint32_t& chunk)
+{
+    std::atomic<std::uint64_t>& bounds = m_ranges[index].bounds;
+    std::uint64_t current = bounds.load(std::memory_order_acquire);
+    while (range_begin(current) < range_end(current))
+    {
+        std::uint64_t next = pack_range(range_begin(current) + 1, range_end(current));
+        if (bounds.compare_exchange_weak(current, next, std::memory_order_acq_rel))
+        {
+            chunk = range_begin(current);
+            return true;
+        }
+    }
+    return false;
+}
+
+bool ThreadPool::steal_chunks(unsigned int index)
+{
+    for (unsigned int offset = 1; offset < m_thread_count; offset++)
+    {
+        std::atomic<std::uint64_t>& victim = m_ranges[(index + offset) % m_thread_count].bounds;
+        std::uint64_t current = victim.load(std::memory_order_acquire);
+        while (range_begin(current) < range_end(current))
+        {
+            std::uint32_t begin = range_begin(current);
+            std::uint32_t end = range_end(current);
+            // take the back half, rounded up so a single chunk can be stolen too
+            std::uint32_t split = begin + (end - begin) / 2;
+            if (victim.compare_exchange_weak(current, pack_range(begin, split), std::memory_order_acq_rel))
+            {
+                // our own range is empty and only we ever refill it
+                m_ranges[index].bounds.store(pack_range(split, end), std::memory_order_release);
+                return true;
+            }
+        }
+    }
+    return false;
+}
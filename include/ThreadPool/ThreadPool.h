@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+/*
+ * Fixed set of worker threads that split index ranges between themselves.
+ * Every participant (the calling thread included) starts with an even slice
+ * of the chunks and pops from the front of it; once its slice is empty it
+ * steals the back half of another participant's slice.
+ * parallel_for does not allocate, so it is safe to call every frame/step.
+ */
+class ThreadPool
+{
+public:
+    explicit ThreadPool(unsigned int thread_count = std::thread::hardware_concurrency());
+
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    // number of participants, including the thread calling parallel_for
+    unsigned int get_thread_count() const;
+
+    // calls body(begin, end) for consecutive sub ranges of [0, count),
+    // each at most grain long, and returns once all of them are done
+    template<typename F>
+    void parallel_for(std::size_t count, std::size_t grain, F&& body)
+    {
+        if (count == 0) return;
+        using body_type = std::remove_reference_t<F>;
+        run(count, grain, [](void* context, std::size_t begin, std::size_t end)
+            {
+                (*static_cast<body_type*>(context))(begin, end);
+            }, (void*) &body);
+    }
+
+private:
+    using m_invoke_function = void (*)(void* context, std::size_t begin, std::size_t end);
+
+    // [begin, end) in chunks, packed so owner pops and thieves steal with a single CAS
+    struct alignas(64) m_range
+    {
+        std::atomic<std::uint64_t> bounds{0};
+    };
+
+    void run(std::size_t count, std::size_t grain, m_invoke_function invoke, void* context);
+
+    void worker_loop(unsigned int index);
+
+    void participate(unsigned int index);
+
+    bool pop_chunk(unsigned int index, std::uint32_t& chunk);
+
+    bool steal_chunks(unsigned int index);
+
+    std::vector<std::thread> m_workers;
+    std::unique_ptr<m_range[]> m_ranges;
+    unsigned int m_thread_count;
+
+    // current job, written before m_generation is bumped
+    m_invoke_function m_invoke = nullptr;
+    void* m_context = nullptr;
+    std::size_t m_count = 0;
+    std::size_t m_grain = 1;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::atomic<std::uint64_t> m_generation{0};
+    std::atomic<unsigned int> m_finished_workers{0};
+    std::atomic<bool> m_stop{false};
+};
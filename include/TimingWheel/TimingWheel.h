@@ -0,0 +1,249 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <type_traits>
+
+// names a scheduled timer, safe to cancel after the timer fired
+struct timer_handle
+{
+    std::uint32_t index = UINT32_MAX;
+    std::uint32_t generation = 0;
+};
+
+/*
+ * Hierarchical timing wheel on integer ticks. Level l has 2^SlotBits slots
+ * that are 2^(SlotBits l) ticks wide each. A timer goes into the level of
+ * the highest digit in which its deadline differs from the current tick,
+ * and moves down when the wheel reaches its slot; deadlines past the top
+ * level wait in an overflow list that is looked at once per turn of the
+ * top level.
+ *
+ * Timers live in a fixed pool of Capacity entries linked by index, so
+ * scheduling and cancelling are O(1), nothing allocates and the wheel is
+ * trivially copyable, small ones can sit in a snapshotted state.
+ * advance() hands the events due on the new tick over in batches.
+ */
+template<typename Event, std::size_t Capacity, std::size_t SlotBits = 6, std::size_t Levels = 4>
+class TimingWheel
+{
+    static_assert(std::is_trivially_copyable_v<Event>);
+    static_assert(Capacity > 0 && SlotBits * Levels < 32);
+
+public:
+    static constexpr std::size_t slot_count = std::size_t(1) << SlotBits;
+    // deadlines at least this far out go to the overflow list
+    static constexpr std::uint32_t horizon = std::uint32_t(1) << (SlotBits * Levels);
+
+    TimingWheel()
+    {
+        clear();
+    }
+
+    // cancels everything, the current tick stays
+    void clear()
+    {
+        m_heads.fill(none);
+        for (std::size_t i = 0; i < Capacity; i++)
+        {
+            m_timers[i].next = i + 1 < Capacity ? static_cast<index_type>(i + 1) : none;
+            m_timers[i].list = no_list;
+        }
+        m_free = 0;
+        m_pending = 0;
+    }
+
+    std::uint32_t get_now() const
+    {
+        return m_now;
+    }
+
+    std::uint32_t get_pending() const
+    {
+        return m_pending;
+    }
+
+    // fires on the advance() that reaches deadline, or on the next one when it's already due.
+    // an empty handle when the pool is full
+    timer_handle schedule(std::uint32_t deadline, Event event)
+    {
+        if (m_free == none)
+        {
+            return {};
+        }
+        index_type index = m_free;
+        m_timer& timer = m_timers[index];
+        m_free = timer.next;
+        // ticks wrap, anything over half a turn behind counts as due
+        timer.deadline = deadline - m_now - 1 < UINT32_MAX / 2 ? deadline : m_now + 1;
+        timer.event = event;
+        timer.generation++;
+        insert(index);
+        m_pending++;
+        return {index, timer.generation};
+    }
+
+    // false when the timer already fired or was cancelled
+    bool cancel(timer_handle handle)
+    {
+        if (handle.index >= Capacity || m_timers[handle.index].generation != handle.generation ||
+            m_timers[handle.index].list == no_list)
+        {
+            return false;
+        }
+        auto index = static_cast<index_type>(handle.index);
+        unlink(index);
+        release(index);
+        return true;
+    }
+
+    // moves on a tick and calls fire(std::span<const Event>) with everything due on it.
+    // the timers are released first, fire may schedule again
+    template<typename F>
+    void advance(F&& fire)
+    {
+        m_now++;
+        if ((m_now & (horizon - 1)) == 0)
+        {
+            redistribute(overflow_list);
+        }
+        // top down, what a level hands on may land in the slot a lower level is about to empty
+        for (std::size_t level = Levels - 1; level > 0; level--)
+        {
+            if ((m_now & ((std::uint32_t(1) << (SlotBits * level)) - 1)) == 0)
+            {
+                redistribute(get_list(level, m_now));
+            }
+        }
+
+        std::size_t list = get_list(0, m_now);
+        index_type index = m_heads[list];
+        m_heads[list] = none;
+        std::array<Event, 64> batch;
+        std::size_t count = 0;
+        while (index != none)
+        {
+            index_type next = m_timers[index].next;
+            batch[count++] = m_timers[index].event;
+            release(index);
+            index = next;
+            if (count == batch.size())
+            {
+                fire(std::span<const Event>(batch.data(), count));
+                count = 0;
+            }
+        }
+        if (count > 0)
+        {
+            fire(std::span<const Event>(batch.data(), count));
+        }
+    }
+
+    // f(deadline, event) for every pending timer, in pool order
+    template<typename F>
+    void for_each_pending(F&& f) const
+    {
+        for (const m_timer& timer: m_timers)
+        {
+            if (timer.list != no_list)
+            {
+                f(timer.deadline, timer.event);
+            }
+        }
+    }
+
+private:
+    static constexpr std::size_t m_list_count = Levels * slot_count + 1;
+
+    using index_type = std::conditional_t<(Capacity < 0xFF), std::uint8_t,
+            std::conditional_t<(Capacity < 0xFFFF), std::uint16_t, std::uint32_t>>;
+    using list_type = std::conditional_t<(m_list_count < 0xFF), std::uint8_t, std::uint16_t>;
+
+    static constexpr index_type none = static_cast<index_type>(-1);
+    static constexpr list_type no_list = static_cast<list_type>(-1);
+    static constexpr std::size_t overflow_list = m_list_count - 1;
+
+    struct m_timer
+    {
+        std::uint32_t deadline;
+        std::uint32_t generation;
+        index_type next;
+        index_type prev;
+        // which of m_heads it's on, no_list while free
+        list_type list;
+        Event event;
+    };
+
+    static std::size_t get_list(std::size_t level, std::uint32_t tick)
+    {
+        return level * slot_count + ((tick >> (SlotBits * level)) & (slot_count - 1));
+    }
+
+    void insert(index_type index)
+    {
+        m_timer& timer = m_timers[index];
+        std::size_t list = overflow_list;
+        if (timer.deadline - m_now < horizon)
+        {
+            // due now only when handed down on the tick it's due, then it goes in the slot being emptied
+            std::uint32_t difference = timer.deadline ^ m_now;
+            std::size_t level = difference ? (std::bit_width(difference) - 1) / SlotBits : 0;
+            list = level < Levels ? get_list(level, timer.deadline) : overflow_list;
+        }
+        timer.list = static_cast<list_type>(list);
+        timer.prev = none;
+        timer.next = m_heads[list];
+        if (timer.next != none)
+        {
+            m_timers[timer.next].prev = index;
+        }
+        m_heads[list] = index;
+    }
+
+    void unlink(index_type index)
+    {
+        m_timer& timer = m_timers[index];
+        if (timer.prev != none)
+        {
+            m_timers[timer.prev].next = timer.next;
+        } else
+        {
+            m_heads[timer.list] = timer.next;
+        }
+        if (timer.next != none)
+        {
+            m_timers[timer.next].prev = timer.prev;
+        }
+    }
+
+    void release(index_type index)
+    {
+        m_timer& timer = m_timers[index];
+        timer.list = no_list;
+        timer.next = m_free;
+        m_free = index;
+        m_pending--;
+    }
+
+    // the wheel caught up with a list, its timers go back in a level lower
+    void redistribute(std::size_t list)
+    {
+        index_type index = m_heads[list];
+        m_heads[list] = none;
+        while (index != none)
+        {
+            index_type next = m_timers[index].next;
+            insert(index);
+            index = next;
+        }
+    }
+
+    std::array<index_type, m_list_count> m_heads{};
+    std::array<m_timer, Capacity> m_timers{};
+    index_type m_free = 0;
+    std::uint32_t m_now = 0;
+    std::uint32_t m_pending = 0;
+};
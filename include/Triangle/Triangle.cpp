@@ -1,5 +1,9 @@
 #include "Triangle.h"
 
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
 Triangle::Triangle(int triangle_width, int triangle_height, int triangle_pos_x,
                    int triangle_pos_y)
         : triangle_width(triangle_width),
@@ -10,64 +14,53 @@ Triangle::Triangle(int triangle_width, int triangle_height, int triangle_pos_x,
 
 }
 
-Triangle::~Triangle()
+void Triangle::draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g,
+                    float b)
 {
-
+    primitives.draw(queue, primitive::TRIANGLE, layer, glm::vec2(triangle_pos_x, triangle_pos_y),
+                    glm::vec2(triangle_width, triangle_height), r, g, b);
 }
 
-void Triangle::draw(unsigned int shader_program, float r, float g, float b)
+namespace
 {
-    glUseProgram(shader_program);
-    glUniform3f(glGetUniformLocation(shader_program, "color"), r, g, b);
-    /*
-    *     B
-    *    / \
-    *   A - C
-    */
-    std::array<int, 8> vertices{
-            triangle_pos_x, triangle_pos_y,                     // A
-            triangle_pos_x + triangle_width / 2,
-            triangle_pos_y + triangle_height,   // B
-            triangle_pos_x + triangle_width,
-            triangle_pos_y,                     // C
-    };
-
-    std::array<GLuint, 6> indices{
-            0, 1, 2,
-    };
-
-    unsigned int VAO, VBO, EBO;
-    glGenVertexArrays(1, &VAO);
-    glGenBuffers(1, &VBO);
-    glGenBuffers(1, &EBO);
-
-    glBindVertexArray(VAO);
-
-    glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(GLuint),
-                 vertices.data(), GL_STATIC_DRAW);
-
-    glVertexAttribPointer(0, 2, GL_INT, GL_FALSE, 2 * sizeof(int),
-                          (const void*) 0);
-    glEnableVertexAttribArray(0);
-
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int),
-                 indices.data(), GL_STATIC_DRAW);
+    // pixels travelled n ticks after spawning at spawn_score, times 60
+    std::int64_t get_travel(std::int64_t n, std::int64_t spawn_score)
+    {
+        return n * (300 + spawn_score) + n * (n + 1) / 2;
+    }
+}
 
-    glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
+void Triangle::spawn(int pos_x, int score)
+{
+    triangle_pos_x = pos_x;
+    spawn_score = score;
+}
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);
-    glBindVertexArray(0);
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+int Triangle::position_at(int score) const
+{
+    std::int64_t n = std::max(score - spawn_score, 0);
+    return static_cast<int>(triangle_pos_x - get_travel(n, spawn_score) / 60);
 }
 
-void Triangle::update_position(int score, double delta_time,
-                               unsigned int screen_width, int reset_pos)
+int Triangle::score_left_of(int x) const
 {
-    triangle_pos_x -= (300 + score) * delta_time;
-    if (triangle_pos_x < reset_pos)
+    // position_at < x once the travel reaches 60 (triangle_pos_x - x + 1)
+    std::int64_t target = std::int64_t(60) * (std::int64_t(triangle_pos_x) - x + 1);
+    if (target <= 0)
+    {
+        return spawn_score;
+    }
+    // n^2 / 2 + (300 + s + 1/2) n = target, then settle the rounding exactly
+    double b = 300.0 + spawn_score + 0.5;
+    auto n = static_cast<std::int64_t>(std::sqrt(b * b + 2.0 * target) - b);
+    n = std::max<std::int64_t>(n, 0);
+    while (n > 0 && get_travel(n - 1, spawn_score) >= target)
+    {
+        n--;
+    }
+    while (get_travel(n, spawn_score) < target)
     {
-        triangle_pos_x = screen_width;
+        n++;
     }
+    return static_cast<int>(spawn_score + n);
 }
@@ -3,6 +3,9 @@
 #include <iostream>
 #include <glbinding/gl/gl.h>
 
+#include "gl_primitives/gl_primitives.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+
 using namespace gl;
 
 class Triangle
@@ -11,16 +14,27 @@ public:
     Triangle(int triangle_width, int triangle_height, int triangle_pos_x,
              int triangle_pos_y);
 
-    ~Triangle();
+    ~Triangle() = default;
+
+    void draw(gl_renderqueue& queue, render_layer layer, gl_primitives& primitives, float r, float g, float b);
+
+    /*
+     * Closed form motion. A triangle moves left at 300 + score px/s and
+     * the score goes up by one every tick, so n ticks after spawning at
+     * score s it has moved (n (300 + s) + n (n + 1) / 2) / 60 pixels.
+     * triangle_pos_x stays where it spawned, the x at any score is
+     * position_at(score), on the CPU and in obstacle.vert alike.
+     */
+    void spawn(int pos_x, int score);
 
-    void draw(unsigned int shader_program, float r, float g, float b);
+    int position_at(int score) const;
 
-    void
-    update_position(int score, double delta_time, unsigned int screen_width,
-                    int reset_pos);
+    // first score at which position_at(score) < x
+    int score_left_of(int x) const;
 
     int triangle_width = 0;
     int triangle_height = 0;
     int triangle_pos_x = 0;
     int triangle_pos_y = 0;
+    int spawn_score = 0;
 };
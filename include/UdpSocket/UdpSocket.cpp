@@ -0,0 +1,148 @@
+#include "UdpSocket.h"
+
+#include <algorithm>
+#include <cstring>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "Logger/Logger.h"
+
+namespace
+{
+    sockaddr_in make_loopback_address(std::uint16_t port)
+    {
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        return address;
+    }
+}
+
+UdpSocket::~UdpSocket()
+{
+    close();
+}
+
+bool UdpSocket::open(std::uint16_t local_port, std::uint16_t remote_port)
+{
+    close();
+
+    m_fd = ::socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_fd < 0)
+    {
+        log_error("NET", "Failed to create socket");
+        return false;
+    }
+    sockaddr_in address = make_loopback_address(local_port);
+    if (::bind(m_fd, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0)
+    {
+        log_error("NET", "Failed to bind 127.0.0.1:{}", local_port);
+        close();
+        return false;
+    }
+    m_remote_port = remote_port;
+    return true;
+}
+
+void UdpSocket::close()
+{
+    if (m_fd >= 0)
+    {
+        ::close(m_fd);
+        m_fd = -1;
+    }
+    m_pending_count = 0;
+}
+
+void UdpSocket::set_conditions(const network_conditions& conditions, std::uint64_t seed)
+{
+    m_conditions = conditions;
+    m_random.state = seed;
+}
+
+void UdpSocket::send(std::span<const std::byte> datagram)
+{
+    flush();
+    if (datagram.size() > max_datagram_size)
+    {
+        log_error("NET", "datagram of {} bytes is too big", datagram.size());
+        return;
+    }
+    m_sent++;
+    if (m_random.next_float() < m_conditions.loss)
+    {
+        m_dropped++;
+        return;
+    }
+
+    double delay_ms = m_conditions.latency_ms + m_random.next_float() * m_conditions.jitter_ms;
+    if (delay_ms <= 0.0)
+    {
+        send_now(datagram);
+        return;
+    }
+    if (m_pending_count == m_pending.size())
+    {
+        // queue full, the simulated link drops it
+        m_dropped++;
+        return;
+    }
+    m_pending_datagram& pending = m_pending[m_pending_count++];
+    pending.due = clock::now() + std::chrono::duration_cast<clock::duration>(
+            std::chrono::duration<double, std::milli>(delay_ms));
+    pending.size = datagram.size();
+    std::copy(datagram.begin(), datagram.end(), pending.data.begin());
+}
+
+std::size_t UdpSocket::receive(std::span<std::byte> buffer)
+{
+    flush();
+    if (m_fd < 0)
+    {
+        return 0;
+    }
+    ssize_t size = ::recv(m_fd, buffer.data(), buffer.size(), 0);
+    return size > 0 ? static_cast<std::size_t>(size) : 0;
+}
+
+std::uint64_t UdpSocket::get_sent() const
+{
+    return m_sent;
+}
+
+std::uint64_t UdpSocket::get_dropped() const
+{
+    return m_dropped;
+}
+
+void UdpSocket::send_now(std::span<const std::byte> datagram)
+{
+    if (m_fd < 0)
+    {
+        return;
+    }
+    sockaddr_in address = make_loopback_address(m_remote_port);
+    ::sendto(m_fd, datagram.data(), datagram.size(), 0, reinterpret_cast<const sockaddr*>(&address),
+             sizeof(address));
+}
+
+void UdpSocket::flush()
+{
+    clock::time_point now = clock::now();
+    std::size_t kept = 0;
+    for (std::size_t i = 0; i < m_pending_count; i++)
+    {
+        if (m_pending[i].due <= now)
+        {
+            send_now({m_pending[i].data.data(), m_pending[i].size});
+        } else
+        {
+            m_pending[kept++] = m_pending[i];
+        }
+    }
+    m_pending_count = kept;
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+
+#include "Random/Random.h"
+
+// applied to outgoing datagrams, to try netcode on loopback
+struct network_conditions
+{
+    double latency_ms = 0.0;
+    // extra delay, uniform in [0, jitter_ms), reorders datagrams
+    double jitter_ms = 0.0;
+    // fraction of datagrams dropped, 0 to 1
+    double loss = 0.0;
+};
+
+/*
+ * Non-blocking UDP socket talking to one peer on 127.0.0.1. Outgoing
+ * datagrams can be held back and dropped to simulate a bad network, they
+ * wait in a fixed queue until due and go out on the next send() or receive().
+ */
+class UdpSocket
+{
+public:
+    static constexpr std::size_t max_datagram_size = 64;
+
+    UdpSocket() = default;
+
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    bool open(std::uint16_t local_port, std::uint16_t remote_port);
+
+    void close();
+
+    void set_conditions(const network_conditions& conditions, std::uint64_t seed);
+
+    void send(std::span<const std::byte> datagram);
+
+    // size of the datagram copied into buffer, 0 when nothing is waiting
+    std::size_t receive(std::span<std::byte> buffer);
+
+    std::uint64_t get_sent() const;
+
+    std::uint64_t get_dropped() const;
+
+private:
+    using clock = std::chrono::steady_clock;
+
+    struct m_pending_datagram
+    {
+        clock::time_point due;
+        std::size_t size;
+        std::array<std::byte, max_datagram_size> data;
+    };
+
+    void send_now(std::span<const std::byte> datagram);
+
+    void flush();
+
+    int m_fd = -1;
+    std::uint16_t m_remote_port = 0;
+    network_conditions m_conditions;
+    Random m_random;
+
+    std::array<m_pending_datagram, 256> m_pending{};
+    std::size_t m_pending_count = 0;
+
+    std::uint64_t m_sent = 0;
+    std::uint64_t m_dropped = 0;
+};
@@ -0,0 +1,560 @@
+#include "gl_backend.h"
+
+#include <Logger/Logger.h>
+
+#include <cstring>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <glbinding/gl/gl.h>
+
+using namespace gl;
+
+namespace
+{
+    const char* const command_names[] = {"use program", "bind vertex array", "bind buffer", "bind texture",
+                                         "set state", "set uniform", "buffer data", "buffer sub data",
+                                         "map buffer", "texture image", "clear", "draw", "read pixels"};
+    static_assert(std::size(command_names) == static_cast<std::size_t>(gl_command::COUNT));
+
+    struct backend_state
+    {
+        gl_backend_mode mode = gl_backend_mode::NULL_DEVICE;
+        unsigned int next_name = 1;
+        // uniform names in declaration order, a uniform's location is its index
+        std::unordered_map<unsigned int, std::vector<std::string>> uniforms;
+        unsigned int vertex_array = 0;
+        unsigned int pack_buffer = 0;
+        std::array<int, 4> viewport{};
+        std::vector<std::byte> map_scratch;
+    };
+
+    backend_state& get_state()
+    {
+        static backend_state state;
+        return state;
+    }
+
+    bool is(unsigned int value, GLenum name)
+    {
+        return value == static_cast<unsigned int>(name);
+    }
+
+    void record(gl_command command, std::uint32_t object = 0, std::size_t amount = 0)
+    {
+        if (get_state().mode == gl_backend_mode::RECORD)
+        {
+            get_gl_command_log().append(command, object, static_cast<std::uint32_t>(amount));
+        }
+    }
+
+    std::size_t get_pixel_size(unsigned int format)
+    {
+        if (is(format, GL_RED))
+        {
+            return 1;
+        }
+        if (is(format, GL_RG))
+        {
+            return 2;
+        }
+        return is(format, GL_RGB) ? 3 : 4;
+    }
+
+    // "uniform vec3 color;" and the like, good enough for the shaders in assets/shaders
+    void add_uniforms(std::string_view source, std::vector<std::string>& names)
+    {
+        for (std::size_t at = source.find("uniform "); at != std::string_view::npos;
+             at = source.find("uniform ", at + 1))
+        {
+            std::size_t end = source.find_first_of(";[", at);
+            if (end == std::string_view::npos)
+            {
+                return;
+            }
+            std::size_t begin = source.find_last_of(" \t", end - 1) + 1;
+            names.emplace_back(source.substr(begin, end - begin));
+        }
+    }
+
+    void gen_names(int count, unsigned int* names)
+    {
+        for (int i = 0; i < count; i++)
+        {
+            names[i] = get_state().next_name++;
+        }
+    }
+
+    unsigned int create_name(unsigned int)
+    {
+        return get_state().next_name++;
+    }
+
+    unsigned int create_program()
+    {
+        return get_state().next_name++;
+    }
+
+    void delete_names(int, const unsigned int*)
+    {
+    }
+
+    void delete_name(unsigned int name)
+    {
+        get_state().uniforms.erase(name);
+    }
+
+    void shader_source(unsigned int shader, int count, const char* const* strings, const int* lengths)
+    {
+        std::vector<std::string>& names = get_state().uniforms[shader];
+        for (int i = 0; i < count; i++)
+        {
+            add_uniforms(lengths && lengths[i] >= 0 ? std::string_view(strings[i], lengths[i])
+                                                    : std::string_view(strings[i]), names);
+        }
+    }
+
+    void name_only(unsigned int)
+    {
+    }
+
+    void attach_shader(unsigned int program, unsigned int shader)
+    {
+        backend_state& state = get_state();
+        std::vector<std::string>& names = state.uniforms[program];
+        const std::vector<std::string>& shader_names = state.uniforms[shader];
+        names.insert(names.end(), shader_names.begin(), shader_names.end());
+    }
+
+    // compile and link status are always GL_TRUE, logs are empty
+    void get_object_parameter(unsigned int, unsigned int parameter, int* value)
+    {
+        *value = is(parameter, GL_COMPILE_STATUS) || is(parameter, GL_LINK_STATUS) ? 1 : 0;
+    }
+
+    void get_info_log(unsigned int, int size, int* length, char* log)
+    {
+        if (length)
+        {
+            *length = 0;
+        }
+        if (size > 0)
+        {
+            log[0] = '\0';
+        }
+    }
+
+    int get_uniform_location(unsigned int program, const char* name)
+    {
+        const std::vector<std::string>& names = get_state().uniforms[program];
+        for (std::size_t i = 0; i < names.size(); i++)
+        {
+            if (names[i] == name)
+            {
+                return static_cast<int>(i);
+            }
+        }
+        return -1;
+    }
+
+    void use_program(unsigned int program)
+    {
+        record(gl_command::USE_PROGRAM, program);
+    }
+
+    void uniform_1f(int location, float)
+    {
+        record(gl_command::SET_UNIFORM, location);
+    }
+
+    void uniform_2f(int location, float, float)
+    {
+        record(gl_command::SET_UNIFORM, location);
+    }
+
+    void uniform_3f(int location, float, float, float)
+    {
+        record(gl_command::SET_UNIFORM, location);
+    }
+
+    void uniform_4f(int location, float, float, float, float)
+    {
+        record(gl_command::SET_UNIFORM, location);
+    }
+
+    void uniform_matrix_4fv(int location, int, unsigned char, const float*)
+    {
+        record(gl_command::SET_UNIFORM, location);
+    }
+
+    void bind_buffer(unsigned int target, unsigned int buffer)
+    {
+        if (is(target, GL_PIXEL_PACK_BUFFER))
+        {
+            get_state().pack_buffer = buffer;
+        }
+        record(gl_command::BIND_BUFFER, buffer);
+    }
+
+    void buffer_data(unsigned int, std::ptrdiff_t size, const void* data, unsigned int)
+    {
+        // storage without data is an allocation, not an upload
+        record(gl_command::BUFFER_DATA, 0, data ? static_cast<std::size_t>(size) : 0);
+    }
+
+    void buffer_sub_data(unsigned int, std::ptrdiff_t, std::ptrdiff_t size, const void*)
+    {
+        record(gl_command::BUFFER_SUB_DATA, 0, static_cast<std::size_t>(size));
+    }
+
+    void* map_buffer_range(unsigned int, std::ptrdiff_t, std::ptrdiff_t length, unsigned int)
+    {
+        std::vector<std::byte>& scratch = get_state().map_scratch;
+        if (scratch.size() < static_cast<std::size_t>(length))
+        {
+            scratch.resize(static_cast<std::size_t>(length));
+        }
+        record(gl_command::MAP_BUFFER, 0, static_cast<std::size_t>(length));
+        return scratch.data();
+    }
+
+    unsigned char unmap_buffer(unsigned int)
+    {
+        return 1;
+    }
+
+    void bind_vertex_array(unsigned int vertex_array)
+    {
+        get_state().vertex_array = vertex_array;
+        record(gl_command::BIND_VERTEX_ARRAY, vertex_array);
+    }
+
+    void vertex_attrib_pointer(unsigned int, int, unsigned int, unsigned char, int, const void*)
+    {
+    }
+
+    void vertex_attrib_divisor(unsigned int, unsigned int)
+    {
+    }
+
+    void bind_texture(unsigned int, unsigned int texture)
+    {
+        record(gl_command::BIND_TEXTURE, texture);
+    }
+
+    void set_parameter(unsigned int, unsigned int, int)
+    {
+    }
+
+    void pixel_store(unsigned int, int)
+    {
+    }
+
+    void tex_image_2d(unsigned int, int, int, int width, int height, int, unsigned int format, unsigned int,
+                      const void* pixels)
+    {
+        record(gl_command::TEXTURE_IMAGE, 0,
+               pixels ? std::size_t(width) * std::size_t(height) * get_pixel_size(format) : 0);
+    }
+
+    void set_capability(unsigned int)
+    {
+        record(gl_command::SET_STATE);
+    }
+
+    void blend_func(unsigned int, unsigned int)
+    {
+        record(gl_command::SET_STATE);
+    }
+
+    void blend_func_separate(unsigned int, unsigned int, unsigned int, unsigned int)
+    {
+        record(gl_command::SET_STATE);
+    }
+
+    void bind_framebuffer(unsigned int, unsigned int)
+    {
+        record(gl_command::SET_STATE);
+    }
+
+    void framebuffer_texture_2d(unsigned int, unsigned int, unsigned int, unsigned int, int)
+    {
+    }
+
+    unsigned int check_framebuffer_status(unsigned int)
+    {
+        return static_cast<unsigned int>(GL_FRAMEBUFFER_COMPLETE);
+    }
+
+    void set_viewport(int x, int y, int width, int height)
+    {
+        get_state().viewport = {x, y, width, height};
+        record(gl_command::SET_STATE);
+    }
+
+    // the viewport is the only query anything asks for, the rest read as zero
+    void get_integer(unsigned int parameter, int* values)
+    {
+        if (is(parameter, GL_VIEWPORT))
+        {
+            std::memcpy(values, get_state().viewport.data(), sizeof(int) * 4);
+            return;
+        }
+        values[0] = 0;
+    }
+
+    void clear_color(float, float, float, float)
+    {
+    }
+
+    void clear(unsigned int)
+    {
+        record(gl_command::CLEAR);
+    }
+
+    void draw_arrays(unsigned int, int, int count)
+    {
+        record(gl_command::DRAW, get_state().vertex_array, static_cast<std::size_t>(count));
+    }
+
+    void draw_elements(unsigned int, int count, unsigned int, const void*)
+    {
+        record(gl_command::DRAW, get_state().vertex_array, static_cast<std::size_t>(count));
+    }
+
+    void draw_arrays_instanced(unsigned int, int, int count, int instances)
+    {
+        record(gl_command::DRAW, get_state().vertex_array, std::size_t(count) * std::size_t(instances));
+    }
+
+    void read_pixels(int, int, int width, int height, unsigned int format, unsigned int, void* pixels)
+    {
+        std::size_t bytes = std::size_t(width) * std::size_t(height) * get_pixel_size(format);
+        // into client memory the pixels are all black, into a pack buffer there's nothing to do
+        if (get_state().pack_buffer == 0 && pixels)
+        {
+            std::memset(pixels, 0, bytes);
+        }
+        record(gl_command::READ_PIXELS, get_state().pack_buffer, bytes);
+    }
+
+    void finish()
+    {
+    }
+
+    void begin_query(unsigned int, unsigned int)
+    {
+    }
+
+    // results are available right away and every query measured nothing
+    void get_query_result(unsigned int, unsigned int parameter, int* value)
+    {
+        *value = is(parameter, GL_QUERY_RESULT_AVAILABLE) ? 1 : 0;
+    }
+
+    void get_query_result_64(unsigned int, unsigned int, std::uint64_t* value)
+    {
+        *value = 0;
+    }
+
+    void* fence_sync(unsigned int, unsigned int)
+    {
+        static int fence;
+        return &fence;
+    }
+
+    void delete_sync(void*)
+    {
+    }
+
+    void get_sync(void*, unsigned int, int count, int* length, int* values)
+    {
+        if (length)
+        {
+            *length = count > 0 ? 1 : 0;
+        }
+        if (count > 0)
+        {
+            values[0] = static_cast<int>(GL_SIGNALED);
+        }
+    }
+
+    unsigned int client_wait_sync(void*, unsigned int, std::uint64_t)
+    {
+        return static_cast<unsigned int>(GL_ALREADY_SIGNALED);
+    }
+
+    template<typename F>
+    gl_backend_proc to_proc(F* function)
+    {
+        return reinterpret_cast<gl_backend_proc>(function);
+    }
+
+    const std::unordered_map<std::string_view, gl_backend_proc>& get_functions()
+    {
+        static const std::unordered_map<std::string_view, gl_backend_proc> functions = {
+                {"glGenBuffers",              to_proc(gen_names)},
+                {"glGenVertexArrays",         to_proc(gen_names)},
+                {"glGenTextures",             to_proc(gen_names)},
+                {"glGenFramebuffers",         to_proc(gen_names)},
+                {"glGenQueries",              to_proc(gen_names)},
+                {"glDeleteBuffers",           to_proc(delete_names)},
+                {"glDeleteVertexArrays",      to_proc(delete_names)},
+                {"glDeleteTextures",          to_proc(delete_names)},
+                {"glDeleteFramebuffers",      to_proc(delete_names)},
+                {"glDeleteQueries",           to_proc(delete_names)},
+                {"glCreateShader",            to_proc(create_name)},
+                {"glCreateProgram",           to_proc(create_program)},
+                {"glDeleteShader",            to_proc(delete_name)},
+                {"glDeleteProgram",           to_proc(delete_name)},
+                {"glShaderSource",            to_proc(shader_source)},
+                {"glCompileShader",           to_proc(name_only)},
+                {"glAttachShader",            to_proc(attach_shader)},
+                {"glLinkProgram",             to_proc(name_only)},
+                {"glGetShaderiv",             to_proc(get_object_parameter)},
+                {"glGetProgramiv",            to_proc(get_object_parameter)},
+                {"glGetShaderInfoLog",        to_proc(get_info_log)},
+                {"glGetProgramInfoLog",       to_proc(get_info_log)},
+                {"glGetUniformLocation",      to_proc(get_uniform_location)},
+                {"glUseProgram",              to_proc(use_program)},
+                {"glUniform1f",               to_proc(uniform_1f)},
+                {"glUniform2f",               to_proc(uniform_2f)},
+                {"glUniform3f",               to_proc(uniform_3f)},
+                {"glUniform4f",               to_proc(uniform_4f)},
+                {"glUniformMatrix4fv",        to_proc(uniform_matrix_4fv)},
+                {"glBindBuffer",              to_proc(bind_buffer)},
+                {"glBufferData",              to_proc(buffer_data)},
+                {"glBufferSubData",           to_proc(buffer_sub_data)},
+                {"glMapBufferRange",          to_proc(map_buffer_range)},
+                {"glUnmapBuffer",             to_proc(unmap_buffer)},
+                {"glBindVertexArray",         to_proc(bind_vertex_array)},
+                {"glEnableVertexAttribArray", to_proc(name_only)},
+                {"glVertexAttribPointer",     to_proc(vertex_attrib_pointer)},
+                {"glVertexAttribDivisor",     to_proc(vertex_attrib_divisor)},
+                {"glActiveTexture",           to_proc(name_only)},
+                {"glBindTexture",             to_proc(bind_texture)},
+                {"glTexParameteri",           to_proc(set_parameter)},
+                {"glTexImage2D",              to_proc(tex_image_2d)},
+                {"glPixelStorei",             to_proc(pixel_store)},
+                {"glEnable",                  to_proc(set_capability)},
+                {"glDisable",                 to_proc(set_capability)},
+                {"glBlendFunc",               to_proc(blend_func)},
+                {"glBlendFuncSeparate",       to_proc(blend_func_separate)},
+                {"glBindFramebuffer",         to_proc(bind_framebuffer)},
+                {"glFramebufferTexture2D",    to_proc(framebuffer_texture_2d)},
+                {"glCheckFramebufferStatus",  to_proc(check_framebuffer_status)},
+                {"glViewport",                to_proc(set_viewport)},
+                {"glGetIntegerv",             to_proc(get_integer)},
+                {"glClearColor",              to_proc(clear_color)},
+                {"glClear",                   to_proc(clear)},
+                {"glDrawArrays",              to_proc(draw_arrays)},
+                {"glDrawElements",            to_proc(draw_elements)},
+                {"glDrawArraysInstanced",     to_proc(draw_arrays_instanced)},
+                {"glReadBuffer",              to_proc(name_only)},
+                {"glReadPixels",              to_proc(read_pixels)},
+                {"glFinish",                  to_proc(finish)},
+                {"glBeginQuery",              to_proc(begin_query)},
+                {"glEndQuery",                to_proc(name_only)},
+                {"glGetQueryObjectiv",        to_proc(get_query_result)},
+                {"glGetQueryObjectui64v",     to_proc(get_query_result_64)},
+                {"glFenceSync",               to_proc(fence_sync)},
+                {"glDeleteSync",              to_proc(delete_sync)},
+                {"glGetSynciv",               to_proc(get_sync)},
+                {"glClientWaitSync",          to_proc(client_wait_sync)}};
+        return functions;
+    }
+}
+
+void set_gl_backend_mode(gl_backend_mode mode)
+{
+    get_state().mode = mode;
+}
+
+gl_backend_proc get_gl_backend_proc_address(const char* name)
+{
+    const auto& functions = get_functions();
+    auto function = functions.find(name);
+    if (function == functions.end())
+    {
+        // a null function pointer makes glbinding skip the call, an entry point gl_jump calls needs a stub here
+        log_error("GL_BACKEND", "{} isn't implemented", name);
+        return nullptr;
+    }
+    return function->second;
+}
+
+gl_command_log::gl_command_log(std::size_t capacity)
+        : m_records(capacity)
+{
+
+}
+
+void gl_command_log::clear()
+{
+    m_size = 0;
+    m_counts = {};
+    m_amounts = {};
+    m_dropped = 0;
+}
+
+void gl_command_log::append(gl_command command, std::uint32_t object, std::uint32_t amount)
+{
+    m_counts[static_cast<std::size_t>(command)]++;
+    m_amounts[static_cast<std::size_t>(command)] += amount;
+    if (m_size == m_records.size())
+    {
+        m_dropped++;
+        return;
+    }
+    m_records[m_size++] = {command, object, amount};
+}
+
+std::span<const gl_command_record> gl_command_log::get_records() const
+{
+    return {m_records.data(), m_size};
+}
+
+std::uint64_t gl_command_log::get_count(gl_command command) const
+{
+    return m_counts[static_cast<std::size_t>(command)];
+}
+
+std::uint64_t gl_command_log::get_amount(gl_command command) const
+{
+    return m_amounts[static_cast<std::size_t>(command)];
+}
+
+std::uint64_t gl_command_log::get_dropped() const
+{
+    return m_dropped;
+}
+
+void gl_command_log::print_report() const
+{
+    std::cout << "GL commands:" << std::endl;
+    for (std::size_t i = 0; i < m_counts.size(); i++)
+    {
+        if (m_counts[i] > 0)
+        {
+            std::cout << "  " << command_names[i] << ": " << m_counts[i];
+            if (m_amounts[i] > 0)
+            {
+                std::cout << " (" << m_amounts[i] << ")";
+            }
+            std::cout << std::endl;
+        }
+    }
+    if (m_dropped > 0)
+    {
+        std::cout << "  " << m_dropped << " records didn't fit in the log" << std::endl;
+    }
+}
+
+gl_command_log& get_gl_command_log()
+{
+    static gl_command_log log(1 << 16);
+    return log;
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+/*
+ * A stand-in for the GL driver, so everything that draws can run without a
+ * context or a display. Pass get_gl_backend_proc_address to
+ * glbinding::initialize in place of glfwGetProcAddress, with lazy
+ * resolution so only the entry points actually called are looked up.
+ *
+ * The subset of GL gl_jump calls is implemented: object names are handed
+ * out, shaders always compile and link, uniform locations come from the
+ * uniforms declared in the shader sources, buffer maps return scratch
+ * memory, fences are always signaled and timer queries measure nothing.
+ * Any other entry point is logged and resolves to null.
+ *
+ * NULL_DEVICE stops there, which leaves the CPU cost of submitting a frame.
+ * RECORD also appends each state change, upload and draw to the
+ * gl_command_log, to check draw sequences and upload volumes.
+ */
+enum class gl_backend_mode
+{
+    NULL_DEVICE, RECORD
+};
+
+void set_gl_backend_mode(gl_backend_mode mode);
+
+using gl_backend_proc = void (*)();
+
+gl_backend_proc get_gl_backend_proc_address(const char* name);
+
+enum class gl_command : std::uint8_t
+{
+    USE_PROGRAM, BIND_VERTEX_ARRAY, BIND_BUFFER, BIND_TEXTURE, SET_STATE, SET_UNIFORM,
+    BUFFER_DATA, BUFFER_SUB_DATA, MAP_BUFFER, TEXTURE_IMAGE, CLEAR, DRAW, READ_PIXELS, COUNT
+};
+
+struct gl_command_record
+{
+    gl_command command;
+    // the program, vertex array, buffer or texture it was about, the bound vertex array for draws
+    std::uint32_t object;
+    // vertices drawn or bytes moved, 0 for state changes
+    std::uint32_t amount;
+};
+
+/*
+ * Commands recorded in RECORD mode. Records past the capacity are still
+ * counted but not kept, so recording never allocates.
+ */
+class gl_command_log
+{
+public:
+    explicit gl_command_log(std::size_t capacity);
+
+    void clear();
+
+    void append(gl_command command, std::uint32_t object, std::uint32_t amount);
+
+    std::span<const gl_command_record> get_records() const;
+
+    std::uint64_t get_count(gl_command command) const;
+
+    // total amount of every command of this kind
+    std::uint64_t get_amount(gl_command command) const;
+
+    // records that didn't fit since the last clear
+    std::uint64_t get_dropped() const;
+
+    void print_report() const;
+
+private:
+    std::vector<gl_command_record> m_records;
+    std::size_t m_size = 0;
+    std::array<std::uint64_t, static_cast<std::size_t>(gl_command::COUNT)> m_counts{};
+    std::array<std::uint64_t, static_cast<std::size_t>(gl_command::COUNT)> m_amounts{};
+    std::uint64_t m_dropped = 0;
+};
+
+gl_command_log& get_gl_command_log();
@@ -0,0 +1,116 @@
+#include "gl_capture.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+gl_capture::gl_capture(unsigned int width, unsigned int height, FrameEncoder& encoder, std::size_t ring_size)
+        : m_width(width),
+          m_height(height),
+          m_encoder(encoder),
+          m_fences(std::max<std::size_t>(ring_size, 1), nullptr)
+{
+    std::size_t bytes = std::size_t(width) * height * 4;
+    m_buffers.reserve(m_fences.size());
+    for (std::size_t i = 0; i < m_fences.size(); i++)
+    {
+        gl_buffer& buffer = m_buffers.emplace_back("capture readback");
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, buffer.get());
+        glBufferData(GL_PIXEL_PACK_BUFFER, bytes, nullptr, GL_STREAM_READ);
+        buffer.set_size(bytes);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+gl_capture::~gl_capture()
+{
+    for (GLsync& fence: m_fences)
+    {
+        if (fence)
+        {
+            glDeleteSync(fence);
+            fence = nullptr;
+        }
+    }
+}
+
+void gl_capture::capture_frame()
+{
+    auto begin = std::chrono::steady_clock::now();
+    // whatever finished copying since last frame goes to the encoder
+    while (m_in_flight > 0 && retire_oldest(false))
+    {
+    }
+    if (m_in_flight == m_buffers.size())
+    {
+        m_stalls++;
+        retire_oldest(true);
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[m_next].get());
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glReadBuffer(GL_BACK);
+    glReadPixels(0, 0, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_fences[m_next] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, GL_NONE_BIT);
+    m_next = (m_next + 1) % m_buffers.size();
+    m_in_flight++;
+    m_frames++;
+    m_readback_ms += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - begin).count();
+}
+
+void gl_capture::finish()
+{
+    while (m_in_flight > 0)
+    {
+        retire_oldest(true);
+    }
+}
+
+void gl_capture::print_report() const
+{
+    std::cout << "capture: " << m_frames << " frames read back, "
+              << (m_frames ? m_readback_ms / static_cast<double>(m_frames) : 0.0)
+              << " ms per frame on the render thread, waited for the GPU " << m_stalls << " times" << std::endl;
+}
+
+bool gl_capture::retire_oldest(bool wait)
+{
+    std::size_t oldest = (m_next + m_buffers.size() - m_in_flight) % m_buffers.size();
+    GLsync& fence = m_fences[oldest];
+    if (wait)
+    {
+        // flushes so the fence can signal at all, then up to a second
+        glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    } else
+    {
+        GLint status = 0;
+        glGetSynciv(fence, GL_SYNC_STATUS, 1, nullptr, &status);
+        if (static_cast<GLenum>(status) != GL_SIGNALED)
+        {
+            return false;
+        }
+    }
+    glDeleteSync(fence);
+    fence = nullptr;
+
+    std::size_t bytes = std::size_t(m_width) * m_height * 4;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_buffers[oldest].get());
+    const void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, bytes, GL_MAP_READ_BIT);
+    if (mapped)
+    {
+        std::span<std::uint8_t> frame = m_encoder.acquire_frame();
+        std::memcpy(frame.data(), mapped, bytes);
+        m_encoder.submit_frame();
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+    } else
+    {
+        log_error("CAPTURE", "Failed to map a readback buffer, a frame is missing");
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    m_in_flight--;
+    return true;
+}
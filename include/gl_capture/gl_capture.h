@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+
+#include "FrameEncoder/FrameEncoder.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Reads every frame back into a ring of pixel pack buffers. glReadPixels
+ * into a bound PBO returns straight away; a fence marks when the copy is
+ * done, and a buffer is only mapped once its fence has signaled, a few
+ * frames later, then copied into the FrameEncoder. The frame loop only
+ * waits on the GPU when the whole ring is still in flight.
+ */
+class gl_capture
+{
+public:
+    gl_capture(unsigned int width, unsigned int height, FrameEncoder& encoder, std::size_t ring_size = 3);
+
+    ~gl_capture();
+
+    gl_capture(const gl_capture&) = delete;
+
+    gl_capture& operator=(const gl_capture&) = delete;
+
+    // reads back what was just drawn, call before swapping buffers
+    void capture_frame();
+
+    // hands every frame still in flight to the encoder
+    void finish();
+
+    void print_report() const;
+
+private:
+    // maps the oldest buffer in flight, waiting for its fence when wait is set.
+    // returns false when it isn't ready and wait isn't set
+    bool retire_oldest(bool wait);
+
+    unsigned int m_width;
+    unsigned int m_height;
+    FrameEncoder& m_encoder;
+    std::vector<gl_buffer> m_buffers;
+    std::vector<GLsync> m_fences;
+    // buffers are filled at m_next and retired m_in_flight behind it
+    std::size_t m_next = 0;
+    std::size_t m_in_flight = 0;
+
+    std::uint64_t m_frames = 0;
+    std::uint64_t m_stalls = 0;
+    double m_readback_ms = 0.0;
+};
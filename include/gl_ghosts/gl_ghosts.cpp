@@ -0,0 +1,73 @@
+#include "gl_ghosts.h"
+
+gl_ghosts::gl_ghosts(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+                     std::size_t capacity, glm::vec2 ghost_size)
+        : m_shader(shader_source),
+          m_capacity(capacity),
+          m_vao("ghosts"),
+          m_square_vbo("ghost square"),
+          m_instance_vbo("ghost instances")
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    glUniform2f(glGetUniformLocation(m_shader.get_shader_program(), "size"), ghost_size.x, ghost_size.y);
+    glUseProgram(0);
+
+    // make_quad without the indices
+    const glm::vec2 square[6] = {{0, 0}, {0, 1}, {1, 1}, {0, 0}, {1, 1}, {1, 0}};
+
+    glBindVertexArray(m_vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_square_vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, sizeof(square), square, GL_STATIC_DRAW);
+    m_square_vbo.set_size(sizeof(square));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (const void*) 0);
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(glm::vec2), nullptr, GL_STREAM_DRAW);
+    m_instance_vbo.set_size(m_capacity * sizeof(glm::vec2));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(glm::vec2), (const void*) 0);
+    glVertexAttribDivisor(1, 1);
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void gl_ghosts::draw(gl_renderqueue& queue, const GhostSystem& ghosts, float r, float g, float b,
+                     render_layer layer)
+{
+    std::size_t count = std::min(ghosts.get_count(), m_capacity);
+    if (count == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_instance_vbo.get());
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(glm::vec2),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    count = ghosts.write_instances({static_cast<glm::vec2*>(mapped), count});
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    if (count == 0)
+    {
+        return;
+    }
+
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader.get_shader_program();
+    draw.vao = m_vao.get();
+    draw.count = 6;
+    draw.instances = static_cast<std::uint32_t>(count);
+    draw.blend = true;
+    draw.color = {r, g, b};
+    queue.submit(draw);
+}
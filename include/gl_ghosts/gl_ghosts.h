@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "GhostSystem/GhostSystem.h"
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Draws every ghost of a GhostSystem as one instanced call: a unit square
+ * in a static buffer, and one corner per ghost streamed into a mapped
+ * instance buffer that is orphaned every frame.
+ */
+class gl_ghosts
+{
+public:
+    gl_ghosts(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+              std::size_t capacity, glm::vec2 ghost_size);
+
+    ~gl_ghosts() = default;
+
+    gl_ghosts(const gl_ghosts&) = delete;
+
+    gl_ghosts& operator=(const gl_ghosts&) = delete;
+
+    void draw(gl_renderqueue& queue, const GhostSystem& ghosts, float r, float g, float b,
+              render_layer layer = render_layer::BACKGROUND);
+
+private:
+    Shader m_shader;
+    std::size_t m_capacity;
+    gl_vertex_array m_vao;
+    gl_buffer m_square_vbo;
+    gl_buffer m_instance_vbo;
+};
@@ -1,40 +1,15 @@
 #include "gl_gridlines.h"
 
-gl_gridlines::gl_gridlines(unsigned int screen_width, unsigned int screen_height, unsigned int grid_size,
-                           std::array<float, 3> line_colors)
+#include "Logger/Logger.h"
+
+gl_gridlines::gl_gridlines(const AssetPack& pack, unsigned int screen_width, unsigned int screen_height,
+                           unsigned int grid_size, std::array<float, 3> line_colors)
         : m_screen_width(screen_width), m_screen_height(screen_height),
           m_grid_size(grid_size), m_line_colors(line_colors)
 {
-    const std::string vertex_shader_source = R"(
-        #version 330 core
-        layout (location = 0) in vec3 pos;
-        layout (location = 1) in float color_alpha;
-
-        out float v_alpha;
-
-        uniform mat4 projection;
-
-        void main()
-        {
-            gl_Position = projection * vec4(pos.xyz, 1.0);
-            v_alpha = color_alpha;
-        }
-    )";
-    const std::string fragment_shader_source = R"(
-        #version 330 core
-
-        out vec4 FragColor;
-
-        in float v_alpha;
-
-        uniform vec3 color;
-
-        void main()
-        {
-            FragColor = vec4(color, v_alpha);
-        }
-    )";
-    m_shader_program = create_shader_program(vertex_shader_source, fragment_shader_source);
+    ShaderSource source = ShaderSource::load(pack, "gridlines");
+    m_shader_program = gl_program::adopt(create_shader_program(source.get_vertex(), source.get_fragment()),
+                                         "gridlines shader");
 
     create_gridline_data();
     setup_gl_objects();
@@ -43,28 +18,31 @@ gl_gridlines::gl_gridlines(unsigned int screen_width, unsigned int screen_height
 
 gl_gridlines::~gl_gridlines()
 {
-    glDeleteVertexArrays(1, &m_vao);
-    glDeleteBuffers(1, &m_vbo);
-    glDeleteBuffers(1, &m_ebo);
-    glDeleteProgram(m_shader_program);
+
 }
 
-void gl_gridlines::draw()
+void gl_gridlines::draw(gl_renderqueue& queue, render_layer layer)
 {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    glUseProgram(m_shader_program);
-    glBindVertexArray(m_vao);
-    glDrawElements(GL_LINES, m_lines * 2, GL_UNSIGNED_INT, nullptr);
-    glBindVertexArray(0);
+    // the grid never changes, so it draws from its own buffers instead of the queue's stream
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader_program.get();
+    draw.vao = m_vao.get();
+    draw.mode = GL_LINES;
+    draw.count = m_lines * 2;
+    draw.indexed = true;
+    draw.blend = true;
+    draw.color = m_line_colors;
+    queue.submit(draw);
 }
 
-unsigned int gl_gridlines::create_shader_program(const std::string& vertex_source, const std::string& fragment_source)
+unsigned int gl_gridlines::create_shader_program(std::string_view vertex_source, std::string_view fragment_source)
 {
     // vertex shader
     unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const char* c_str_vertex = vertex_source.c_str();
-    glShaderSource(vertexShader, 1, &c_str_vertex, nullptr);
+    const char* c_str_vertex = vertex_source.data();
+    GLint vertex_length = static_cast<GLint>(vertex_source.size());
+    glShaderSource(vertexShader, 1, &c_str_vertex, &vertex_length);
     glCompileShader(vertexShader);
     // check for shader compile errors
     int success;
@@ -73,19 +51,20 @@ unsigned int gl_gridlines::create_shader_program(const std::string& vertex_sourc
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::VERTEX::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // fragment shader
     unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* c_str_fragment = fragment_source.c_str();
-    glShaderSource(fragmentShader, 1, &c_str_fragment, nullptr);
+    const char* c_str_fragment = fragment_source.data();
+    GLint fragment_length = static_cast<GLint>(fragment_source.size());
+    glShaderSource(fragmentShader, 1, &c_str_fragment, &fragment_length);
     glCompileShader(fragmentShader);
     // check for shader compile errors
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::FRAGMENT::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // link shaders
     unsigned int shaderProgram = glCreateProgram();
@@ -97,7 +76,7 @@ unsigned int gl_gridlines::create_shader_program(const std::string& vertex_sourc
     if (!success)
     {
         glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::PROGRAM::LINKING_FAILED", "\n{}", infoLog);
     }
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
@@ -171,17 +150,19 @@ void gl_gridlines::create_gridline_data()
 
 void gl_gridlines::setup_gl_objects()
 {
-    glGenVertexArrays(1, &m_vao);
-    glGenBuffers(1, &m_vbo);
-    glGenBuffers(1, &m_ebo);
+    m_vao = gl_vertex_array("gridlines");
+    m_vbo = gl_buffer("gridlines vertices");
+    m_ebo = gl_buffer("gridlines indices");
 
-    glBindVertexArray(m_vao);
+    glBindVertexArray(m_vao.get());
 
-    glBindBuffer(GL_ARRAY_BUFFER, m_vbo);
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
     glBufferData(GL_ARRAY_BUFFER, m_vertices.size() * sizeof(m_vertex), m_vertices.data(), GL_STATIC_DRAW);
+    m_vbo.set_size(m_vertices.size() * sizeof(m_vertex));
 
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo.get());
     glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indices.size() * sizeof(unsigned int), m_indices.data(), GL_STATIC_DRAW);
+    m_ebo.set_size(m_indices.size() * sizeof(unsigned int));
 
     glVertexAttribPointer(0, 3, GL_INT, GL_FALSE, sizeof(m_vertex), (const void*)offsetof(m_vertex, position));
     glEnableVertexAttribArray(0);
@@ -197,9 +178,8 @@ void gl_gridlines::setup_gl_objects()
 void gl_gridlines::set_projection_view()
 {
     glm::mat4 projection = glm::ortho(0.0f, (float) m_screen_width, 0.0f, (float) m_screen_height);
-    glUseProgram(m_shader_program);
-    glUniformMatrix4fv(glGetUniformLocation(m_shader_program, "projection"), 1, GL_FALSE, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(m_shader_program, "color"), m_line_colors[0], m_line_colors[1], m_line_colors[2]);
+    glUseProgram(m_shader_program.get());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader_program.get(), "projection"), 1, GL_FALSE, glm::value_ptr(projection));
 }
 
 
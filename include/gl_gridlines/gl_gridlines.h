@@ -6,17 +6,22 @@
 #include "glm/gtc/matrix_transform.hpp"
 #include <glm/gtc/type_ptr.hpp>
 
+#include "AssetPack/AssetPack.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
 using namespace gl;
 
 class gl_gridlines
 {
 public:
-    gl_gridlines(unsigned int screen_width, unsigned int screen_height, unsigned int grid_size,
-                 std::array<float, 3> line_colors);
+    gl_gridlines(const AssetPack& pack, unsigned int screen_width, unsigned int screen_height,
+                 unsigned int grid_size, std::array<float, 3> line_colors);
 
     ~gl_gridlines();
 
-    void draw();
+    void draw(gl_renderqueue& queue, render_layer layer = render_layer::BACKGROUND);
 
 private:
     struct m_vertex {
@@ -25,9 +30,10 @@ private:
     };
     unsigned int m_screen_width;
     unsigned int m_screen_height;
-    unsigned int m_shader_program;
+    gl_program m_shader_program;
 
-    unsigned int m_vbo, m_vao, m_ebo;
+    gl_buffer m_vbo, m_ebo;
+    gl_vertex_array m_vao;
     std::vector<m_vertex> m_vertices;
     std::vector<unsigned int> m_indices;
 
@@ -35,7 +41,7 @@ private:
     std::array<float, 3> m_line_colors;
     unsigned int m_lines = 0;
 
-    unsigned int create_shader_program(const std::string& vertex_source, const std::string& fragment_source);
+    unsigned int create_shader_program(std::string_view vertex_source, std::string_view fragment_source);
 
     void create_gridline_data();
 
@@ -0,0 +1,100 @@
+#include "gl_layer.h"
+
+#include <array>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+gl_layer::gl_layer(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+                   const char* label)
+        : m_width(screen_width),
+          m_height(screen_height),
+          m_label(label),
+          m_shader(shader_source),
+          m_texture(label),
+          m_framebuffer(label)
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    glUseProgram(0);
+
+    // one texel per pixel, nothing to filter
+    glBindTexture(GL_TEXTURE_2D, m_texture.get());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_texture.set_size(std::size_t(m_width) * m_height * 4);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer.get());
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture.get(), 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        log_error("LAYER", "{} framebuffer is incomplete", m_label);
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+}
+
+bool gl_layer::is_stale(std::uint64_t key) const
+{
+    return !m_valid || key != m_key;
+}
+
+void gl_layer::invalidate()
+{
+    m_valid = false;
+}
+
+void gl_layer::render(gl_renderqueue& queue, std::uint64_t key)
+{
+    // the window's framebuffer may have more pixels than the screen, on high DPI displays
+    std::array<GLint, 4> viewport{};
+    glGetIntegerv(GL_VIEWPORT, viewport.data());
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer.get());
+    glViewport(0, 0, m_width, m_height);
+    glClearColor(0.0f, 0.0f, 0.0f, 0.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    queue.execute();
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+
+    m_key = key;
+    m_valid = true;
+    m_renders++;
+}
+
+void gl_layer::draw(gl_renderqueue& queue, render_layer layer)
+{
+    if (!m_valid)
+    {
+        return;
+    }
+    auto w = static_cast<float>(m_width);
+    auto h = static_cast<float>(m_height);
+    gl_renderqueue::command quad;
+    std::span<gl_renderqueue::vertex> vertices = queue.allocate_vertices(6, quad.first);
+    vertices[0] = {{0.0f, h}, {0.0f, 1.0f}};
+    vertices[1] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+    vertices[2] = {{w, 0.0f}, {1.0f, 0.0f}};
+    vertices[3] = {{0.0f, h}, {0.0f, 1.0f}};
+    vertices[4] = {{w, 0.0f}, {1.0f, 0.0f}};
+    vertices[5] = {{w, h}, {1.0f, 1.0f}};
+
+    quad.layer = layer;
+    quad.program = m_shader.get_shader_program();
+    quad.texture = m_texture.get();
+    quad.count = 6;
+    quad.blend = true;
+    queue.submit(quad);
+    m_draws++;
+}
+
+void gl_layer::print_report() const
+{
+    std::cout << m_label << ": rendered " << m_renders << " times, drawn " << m_draws << " times" << std::endl;
+}
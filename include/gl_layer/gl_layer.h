@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Screen sized texture caching content that rarely changes. The owner
+ * boils whatever the content depends on down to a key; while the key
+ * stays the same, draw() puts the texture on the frame with one textured
+ * quad. When it changes, the content is submitted to a queue of its own
+ * and render() draws that into the texture first:
+ *
+ *   if (layer.is_stale(key))
+ *   {
+ *       textrenderer.render_text(layer_queue, ...);
+ *       layer.render(layer_queue, key);
+ *   }
+ *   layer.draw(render_queue, render_layer::HUD);
+ *
+ * The texture holds premultiplied color, layer.frag divides it back out
+ * so the quad blends like the draws it stands in for.
+ */
+class gl_layer
+{
+public:
+    // label must outlive the layer, it names the GL objects and the report
+    gl_layer(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+             const char* label);
+
+    ~gl_layer() = default;
+
+    gl_layer(const gl_layer&) = delete;
+
+    gl_layer& operator=(const gl_layer&) = delete;
+
+    bool is_stale(std::uint64_t key) const;
+
+    // the next is_stale is true whatever the key
+    void invalidate();
+
+    // executes queue into the texture, which then holds the content for key
+    void render(gl_renderqueue& queue, std::uint64_t key);
+
+    void draw(gl_renderqueue& queue, render_layer layer);
+
+    void print_report() const;
+
+private:
+    unsigned int m_width;
+    unsigned int m_height;
+    const char* m_label;
+    Shader m_shader;
+    gl_texture m_texture;
+    gl_framebuffer m_framebuffer;
+    std::uint64_t m_key = 0;
+    bool m_valid = false;
+
+    std::uint64_t m_renders = 0;
+    std::uint64_t m_draws = 0;
+};
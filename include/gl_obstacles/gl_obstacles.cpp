@@ -0,0 +1,89 @@
+#include "gl_obstacles.h"
+
+#include <iostream>
+
+gl_obstacles::gl_obstacles(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source)
+        : m_shader(shader_source),
+          m_vao("obstacles"),
+          m_vbo("obstacle slots")
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    m_ticks_location = glGetUniformLocation(m_shader.get_shader_program(), "ticks");
+    glUseProgram(0);
+
+    glBindVertexArray(m_vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, slot_count * 3 * sizeof(m_vertex), nullptr, GL_DYNAMIC_DRAW);
+    m_vbo.set_size(slot_count * 3 * sizeof(m_vertex));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(m_vertex), (const void*) offsetof(m_vertex, position));
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(m_vertex),
+                          (const void*) offsetof(m_vertex, spawn_score));
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void gl_obstacles::set(std::size_t slot, const Triangle& triangle)
+{
+    m_spawn spawn = {triangle.triangle_pos_x, triangle.triangle_pos_y, triangle.triangle_width,
+                     triangle.triangle_height, triangle.spawn_score, true};
+    if (slot >= slot_count || m_spawns[slot] == spawn)
+    {
+        return;
+    }
+    m_spawns[slot] = spawn;
+
+    // same corners as make_triangle
+    auto x = static_cast<float>(spawn.pos_x);
+    auto y = static_cast<float>(spawn.pos_y);
+    auto s = static_cast<float>(spawn.spawn_score);
+    const m_vertex vertices[3] = {
+            {{x, y}, s},
+            {{x + static_cast<float>(spawn.width / 2), y + static_cast<float>(spawn.height)}, s},
+            {{x + static_cast<float>(spawn.width), y}, s}};
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    glBufferSubData(GL_ARRAY_BUFFER, slot * sizeof(vertices), sizeof(vertices), vertices);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    m_uploads++;
+    m_upload_bytes += sizeof(vertices);
+}
+
+void gl_obstacles::set_ticks(float ticks)
+{
+    // the queue rebinds programs from scratch every execute, binding here doesn't confuse it
+    glUseProgram(m_shader.get_shader_program());
+    glUniform1f(m_ticks_location, ticks);
+    glUseProgram(0);
+    m_frames++;
+}
+
+void gl_obstacles::draw(gl_renderqueue& queue, std::size_t slot, render_layer layer, float r, float g, float b)
+{
+    if (slot >= slot_count || !m_spawns[slot].uploaded)
+    {
+        return;
+    }
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader.get_shader_program();
+    draw.vao = m_vao.get();
+    draw.first = static_cast<std::uint32_t>(slot * 3);
+    draw.count = 3;
+    draw.color = {r, g, b};
+    queue.submit(draw);
+}
+
+void gl_obstacles::print_report() const
+{
+    std::cout << "obstacles: " << m_uploads << " uploads, " << m_upload_bytes << " bytes over " << m_frames
+              << " frames";
+    if (m_frames > 0)
+    {
+        std::cout << " (" << static_cast<double>(m_upload_bytes) / static_cast<double>(m_frames) << " bytes/frame)";
+    }
+    std::cout << std::endl;
+}
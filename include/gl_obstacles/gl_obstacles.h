@@ -0,0 +1,77 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "Triangle/Triangle.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Draws triangles that move along Triangle's closed form path. Each slot
+ * keeps its three vertices where the triangle spawned, together with the
+ * score it spawned at, and obstacle.vert moves them by the "ticks"
+ * uniform, fractional ticks included. A slot is only uploaded again when
+ * its triangle respawns, so scrolling costs no vertex bandwidth at all.
+ */
+class gl_obstacles
+{
+public:
+    static constexpr std::size_t slot_count = 4;
+
+    gl_obstacles(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source);
+
+    ~gl_obstacles() = default;
+
+    gl_obstacles(const gl_obstacles&) = delete;
+
+    gl_obstacles& operator=(const gl_obstacles&) = delete;
+
+    // uploads the slot when triangle spawned since the last call
+    void set(std::size_t slot, const Triangle& triangle);
+
+    // score the frame is drawn at, between two ticks while the accumulator fills
+    void set_ticks(float ticks);
+
+    void draw(gl_renderqueue& queue, std::size_t slot, render_layer layer, float r, float g, float b);
+
+    void print_report() const;
+
+private:
+    struct m_vertex
+    {
+        glm::vec2 position;
+        float spawn_score;
+    };
+
+    struct m_spawn
+    {
+        int pos_x = 0;
+        int pos_y = 0;
+        int width = 0;
+        int height = 0;
+        int spawn_score = 0;
+        bool uploaded = false;
+
+        bool operator==(const m_spawn&) const = default;
+    };
+
+    Shader m_shader;
+    int m_ticks_location;
+    gl_vertex_array m_vao;
+    gl_buffer m_vbo;
+    std::array<m_spawn, slot_count> m_spawns{};
+    std::uint64_t m_uploads = 0;
+    std::uint64_t m_upload_bytes = 0;
+    std::uint64_t m_frames = 0;
+};
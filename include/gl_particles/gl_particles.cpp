@@ -0,0 +1,82 @@
+#include "gl_particles.h"
+
+gl_particles::gl_particles(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+                           std::size_t capacity)
+        : m_shader(shader_source),
+          m_capacity(capacity),
+          m_vao("particles"),
+          m_vbo("particle stream")
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    m_point_scale_location = glGetUniformLocation(m_shader.get_shader_program(), "point_scale");
+    glUniform1f(m_point_scale_location, 1.0f);
+    glUseProgram(0);
+
+    // the vertex shader picks the point size per particle
+    glEnable(GL_PROGRAM_POINT_SIZE);
+
+    glBindVertexArray(m_vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, m_capacity * sizeof(ParticleSystem::vertex), nullptr, GL_STREAM_DRAW);
+    m_vbo.set_size(m_capacity * sizeof(ParticleSystem::vertex));
+
+    using vertex = ParticleSystem::vertex;
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex), (const void*) offsetof(vertex, position));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 1, GL_FLOAT, GL_FALSE, sizeof(vertex), (const void*) offsetof(vertex, size));
+
+    glEnableVertexAttribArray(2);
+    glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(vertex), (const void*) offsetof(vertex, color));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void gl_particles::set_point_scale(float scale)
+{
+    if (scale == m_point_scale)
+    {
+        return;
+    }
+    glUseProgram(m_shader.get_shader_program());
+    glUniform1f(m_point_scale_location, scale);
+    glUseProgram(0);
+    m_point_scale = scale;
+}
+
+void gl_particles::draw(gl_renderqueue& queue, const ParticleSystem& particles, render_layer layer)
+{
+    std::size_t count = std::min(particles.get_count(), m_capacity);
+    if (count == 0)
+    {
+        return;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    // invalidating hands the driver fresh storage instead of waiting on the last draw
+    void* mapped = glMapBufferRange(GL_ARRAY_BUFFER, 0, count * sizeof(ParticleSystem::vertex),
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+        return;
+    }
+    count = particles.write_vertices({static_cast<ParticleSystem::vertex*>(mapped), count});
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader.get_shader_program();
+    draw.vao = m_vao.get();
+    draw.mode = GL_POINTS;
+    draw.count = static_cast<std::uint32_t>(count);
+    draw.blend = true;
+    draw.color = {1.0f, 1.0f, 1.0f};
+    queue.submit(draw);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "ParticleSystem/ParticleSystem.h"
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Draws a ParticleSystem as one GL_POINTS call. The particles are written
+ * straight into a mapped streaming buffer sized for the system's capacity,
+ * which is orphaned every frame so the GPU never stalls on last frame's points.
+ */
+class gl_particles
+{
+public:
+    gl_particles(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+                 std::size_t capacity);
+
+    ~gl_particles() = default;
+
+    gl_particles(const gl_particles&) = delete;
+
+    gl_particles& operator=(const gl_particles&) = delete;
+
+    // points keep their size on screen when the target is drawn at a fraction of it
+    void set_point_scale(float scale);
+
+    void draw(gl_renderqueue& queue, const ParticleSystem& particles, render_layer layer = render_layer::WORLD);
+
+private:
+    Shader m_shader;
+    std::size_t m_capacity;
+    gl_vertex_array m_vao;
+    gl_buffer m_vbo;
+    int m_point_scale_location;
+    float m_point_scale = 1.0f;
+};
@@ -0,0 +1,73 @@
+#include "gl_perfoverlay.h"
+
+#include <algorithm>
+
+gl_perfoverlay::gl_perfoverlay(unsigned int screen_width, unsigned int screen_height, unsigned int shape_program)
+        : m_screen_width(screen_width),
+          m_screen_height(screen_height),
+          m_shape_program(shape_program)
+{
+
+}
+
+void gl_perfoverlay::draw(gl_renderqueue& queue, gl_textrenderer& textrenderer, const FrameStats& stats)
+{
+    auto start = std::chrono::steady_clock::now();
+
+    std::array<frame_sample, m_window> samples;
+    std::size_t count = stats.read_recent(samples);
+    frame_summary summary = stats.summarize(m_window);
+    frame_sample last = count > 0 ? samples[count - 1] : frame_sample{};
+
+    float left = static_cast<float>(m_screen_width) - m_window - 10.0f;
+    float top = static_cast<float>(m_screen_height) - 20.0f;
+    float line_height = 15.0f;
+
+    m_line.clear();
+    m_line.append("fps ").append(summary.fps, 1).append("  sim ").append(summary.sim_ms, 3).append(" ms");
+    textrenderer.render_text(queue, m_line.view(), left, top);
+
+    m_line.clear();
+    m_line.append("p50 ").append(summary.p50_ms, 2).append("  p95 ").append(summary.p95_ms, 2);
+    textrenderer.render_text(queue, m_line.view(), left, top - line_height);
+
+    m_line.clear();
+    m_line.append("p99 ").append(summary.p99_ms, 2).append("  max ").append(summary.max_ms, 2).append(" ms");
+    textrenderer.render_text(queue, m_line.view(), left, top - line_height * 2);
+
+    m_line.clear();
+    m_line.append("draws ").append(static_cast<int>(last.draw_calls))
+          .append("  gl objs ").append(static_cast<int>(last.gl_objects))
+          .append("  self ").append(m_cost_ms, 3);
+    textrenderer.render_text(queue, m_line.view(), left, top - line_height * 3);
+
+    // the graph, newest sample on the right
+    if (count >= 2)
+    {
+        float bottom = top - line_height * 4 - m_graph_height;
+        float x = left + static_cast<float>(m_window - count);
+        std::uint32_t first;
+        std::span<gl_renderqueue::vertex> vertices = queue.allocate_vertices(count, first);
+        for (std::size_t i = 0; i < count; i++)
+        {
+            float height = std::min(samples[i].frame_ms, m_graph_max_ms) / m_graph_max_ms * m_graph_height;
+            vertices[i] = {{x + i, bottom + height}};
+        }
+
+        gl_renderqueue::command graph;
+        graph.layer = render_layer::HUD;
+        graph.program = m_shape_program;
+        graph.mode = GL_LINE_STRIP;
+        graph.first = first;
+        graph.count = static_cast<std::uint32_t>(count);
+        graph.color = {0.2f, 0.9f, 0.3f};
+        queue.submit(graph);
+    }
+
+    m_cost_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+double gl_perfoverlay::get_cost_ms() const
+{
+    return m_cost_ms;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <chrono>
+
+#include "FixedText/FixedText.h"
+#include "FrameStats/FrameStats.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_textrenderer/gl_textrenderer.h"
+
+/*
+ * FPS, frame time percentiles, sim time, draw calls and live GL objects in
+ * the top right corner, over a graph of the recent frame times drawn as a
+ * single line strip. It only reads FrameStats, so a disabled overlay costs
+ * nothing beyond the recording itself.
+ */
+class gl_perfoverlay
+{
+public:
+    // shape_program draws the graph, it needs a "color" uniform and the shared projection
+    gl_perfoverlay(unsigned int screen_width, unsigned int screen_height, unsigned int shape_program);
+
+    void draw(gl_renderqueue& queue, gl_textrenderer& textrenderer, const FrameStats& stats);
+
+    // time the last draw() took on the CPU
+    double get_cost_ms() const;
+
+private:
+    // samples in the graph and the percentiles, one pixel per sample
+    static constexpr std::size_t m_window = 240;
+    static constexpr float m_graph_height = 60.0f;
+    // frame times above this are clamped to the top of the graph
+    static constexpr float m_graph_max_ms = 33.3f;
+
+    unsigned int m_screen_width;
+    unsigned int m_screen_height;
+    unsigned int m_shape_program;
+    FixedText<48> m_line;
+    double m_cost_ms = 0.0;
+};
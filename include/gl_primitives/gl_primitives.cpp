@@ -0,0 +1,50 @@
+#include "gl_primitives.h"
+
+gl_primitives::gl_primitives(unsigned int screen_width, unsigned int screen_height,
+                             const ShaderSource& shader_source)
+        : m_shader(shader_source),
+          m_vao("primitives"),
+          m_vbo("primitive vertices"),
+          m_ebo("primitive indices")
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    glUseProgram(0);
+
+    glBindVertexArray(m_vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    glBufferData(GL_ARRAY_BUFFER, sizeof(primitive_meshes.vertices), primitive_meshes.vertices.data(),
+                 GL_STATIC_DRAW);
+    m_vbo.set_size(sizeof(primitive_meshes.vertices));
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(primitive_vertex), (const void*) 0);
+    // the element buffer binding is part of the VAO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_ebo.get());
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(primitive_meshes.indices), primitive_meshes.indices.data(),
+                 GL_STATIC_DRAW);
+    m_ebo.set_size(sizeof(primitive_meshes.indices));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+}
+
+void gl_primitives::draw(gl_renderqueue& queue, primitive shape, render_layer layer, glm::vec2 position,
+                         glm::vec2 size, float r, float g, float b)
+{
+    const primitive_range& range = primitive_meshes.ranges[static_cast<std::size_t>(shape)];
+
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader.get_shader_program();
+    draw.vao = m_vao.get();
+    draw.mode = range.lines ? GL_LINES : GL_TRIANGLES;
+    draw.first = range.first;
+    draw.count = range.count;
+    draw.indexed = true;
+    draw.color = {r, g, b};
+    draw.transform = {size.x, size.y, position.x, position.y};
+    queue.submit(draw);
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Primitives/Primitives.h"
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * The compile time meshes of Primitives.h in one static vertex and index
+ * buffer, uploaded when this is constructed. A shape is drawn from its
+ * range with nothing but the "transform" and "color" uniforms, so drawing
+ * one writes no vertices at all.
+ */
+class gl_primitives
+{
+public:
+    gl_primitives(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source);
+
+    ~gl_primitives() = default;
+
+    gl_primitives(const gl_primitives&) = delete;
+
+    gl_primitives& operator=(const gl_primitives&) = delete;
+
+    // the unit mesh scaled by size and moved to position
+    void draw(gl_renderqueue& queue, primitive shape, render_layer layer, glm::vec2 position, glm::vec2 size,
+              float r, float g, float b);
+
+private:
+    Shader m_shader;
+    gl_vertex_array m_vao;
+    gl_buffer m_vbo;
+    gl_buffer m_ebo;
+};
@@ -0,0 +1,275 @@
+#include "gl_renderqueue.h"
+
+#include "FrameArena/FrameArena.h"
+#include "Logger/Logger.h"
+
+namespace
+{
+    constexpr unsigned int unknown_binding = ~0u;
+
+    std::uint64_t make_sort_key(const gl_renderqueue::command& draw, std::uint32_t depth)
+    {
+        return (static_cast<std::uint64_t>(draw.layer) << 56) |
+               (static_cast<std::uint64_t>(draw.program & 0xFFF) << 44) |
+               (static_cast<std::uint64_t>(draw.texture & 0xFFF) << 32) |
+               depth;
+    }
+}
+
+gl_renderqueue::gl_renderqueue()
+        : m_vao("render queue stream"),
+          m_vbo("render queue stream")
+{
+    m_commands.reserve(1024);
+    m_vertices.resize(16384);
+
+    glBindVertexArray(m_vao.get());
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+
+    glEnableVertexAttribArray(0);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(vertex), (const void*) offsetof(vertex, position));
+
+    glEnableVertexAttribArray(1);
+    glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(vertex),
+                          (const void*) offsetof(vertex, texture_coordinates));
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+std::span<gl_renderqueue::vertex> gl_renderqueue::allocate_vertices(std::size_t count, std::uint32_t& first)
+{
+    if (m_vertex_count + count > m_vertices.size())
+    {
+        // only grows while warming up, the stream keeps its size afterwards
+        m_vertices.resize((m_vertex_count + count) * 2);
+    }
+    first = static_cast<std::uint32_t>(m_vertex_count);
+    m_vertex_count += count;
+    return {m_vertices.data() + first, count};
+}
+
+void gl_renderqueue::submit(const command& draw)
+{
+    if (draw.count == 0)
+    {
+        return;
+    }
+    m_commands.push_back(draw);
+}
+
+void gl_renderqueue::execute()
+{
+    m_draw_calls = 0;
+    m_state_changes = 0;
+    m_bound_program = unknown_binding;
+    m_bound_vao = unknown_binding;
+    m_bound_texture = unknown_binding;
+    m_blend_state = -1;
+    // another queue, like a gl_layer's, may have set the same programs' uniforms since
+    for (m_program_state& program: m_program_states)
+    {
+        program.color_set = false;
+        program.transform_set = false;
+    }
+
+    std::span<m_sort_entry> entries = get_frame_arena().allocate<m_sort_entry>(m_commands.size());
+    std::span<m_sort_entry> scratch = get_frame_arena().allocate<m_sort_entry>(m_commands.size());
+    if (entries.size() != m_commands.size() || scratch.size() != m_commands.size())
+    {
+        log_error("RENDERQUEUE", "no room to sort {} commands", m_commands.size());
+        m_commands.clear();
+        m_vertex_count = 0;
+        return;
+    }
+    for (std::uint32_t i = 0; i < m_commands.size(); i++)
+    {
+        entries[i] = {make_sort_key(m_commands[i], i), i};
+    }
+    sort(entries, scratch);
+
+    // the whole frame's stream in one upload, orphaning last frame's storage
+    glBindBuffer(GL_ARRAY_BUFFER, m_vbo.get());
+    std::size_t bytes = m_vertex_count * sizeof(vertex);
+    if (bytes > m_vbo_capacity)
+    {
+        m_vbo_capacity = m_vertices.size() * sizeof(vertex);
+        m_vbo.set_size(m_vbo_capacity);
+    }
+    glBufferData(GL_ARRAY_BUFFER, m_vbo_capacity, nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, bytes, m_vertices.data());
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    std::size_t i = 0;
+    while (i < entries.size())
+    {
+        command draw = m_commands[entries[i].index];
+        // fold in following draws that continue this one with the same state
+        std::size_t next = i + 1;
+        while (next < entries.size() && can_merge(draw, m_commands[entries[next].index]))
+        {
+            draw.count += m_commands[entries[next].index].count;
+            next++;
+        }
+        i = next;
+
+        apply_state(draw);
+        if (draw.instances > 0)
+        {
+            glDrawArraysInstanced(draw.mode, draw.first, draw.count, draw.instances);
+        } else if (draw.indexed)
+        {
+            glDrawElements(draw.mode, draw.count, GL_UNSIGNED_INT,
+                           (const void*) (static_cast<std::size_t>(draw.first) * sizeof(unsigned int)));
+        } else
+        {
+            glDrawArrays(draw.mode, draw.first, draw.count);
+        }
+        m_draw_calls++;
+    }
+
+    glBindVertexArray(0);
+    m_commands.clear();
+    m_vertex_count = 0;
+}
+
+unsigned int gl_renderqueue::get_draw_calls() const
+{
+    return m_draw_calls;
+}
+
+unsigned int gl_renderqueue::get_state_changes() const
+{
+    return m_state_changes;
+}
+
+void gl_renderqueue::sort(std::span<m_sort_entry> entries, std::span<m_sort_entry> scratch)
+{
+    if (entries.size() < 2)
+    {
+        return;
+    }
+
+    // LSD radix sort, a byte per pass, passes where every key has the same byte are skipped
+    std::span<m_sort_entry> source = entries;
+    std::span<m_sort_entry> destination = scratch;
+    for (int shift = 0; shift < 64; shift += 8)
+    {
+        std::array<std::uint32_t, 256> counts{};
+        for (const m_sort_entry& entry: source)
+        {
+            counts[(entry.key >> shift) & 0xFF]++;
+        }
+        if (counts[(source[0].key >> shift) & 0xFF] == source.size())
+        {
+            continue;
+        }
+
+        std::uint32_t offset = 0;
+        for (std::uint32_t& count: counts)
+        {
+            std::uint32_t bucket_size = count;
+            count = offset;
+            offset += bucket_size;
+        }
+        for (const m_sort_entry& entry: source)
+        {
+            destination[counts[(entry.key >> shift) & 0xFF]++] = entry;
+        }
+        std::swap(source, destination);
+    }
+    if (source.data() != entries.data())
+    {
+        std::copy(source.begin(), source.end(), entries.begin());
+    }
+}
+
+void gl_renderqueue::apply_state(const command& draw)
+{
+    if (draw.program != m_bound_program)
+    {
+        glUseProgram(draw.program);
+        m_bound_program = draw.program;
+        m_state_changes++;
+    }
+
+    unsigned int vao = draw.vao ? draw.vao : m_vao.get();
+    if (vao != m_bound_vao)
+    {
+        glBindVertexArray(vao);
+        m_bound_vao = vao;
+        m_state_changes++;
+    }
+
+    if (draw.texture != m_bound_texture)
+    {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, draw.texture);
+        m_bound_texture = draw.texture;
+        m_state_changes++;
+    }
+
+    if (static_cast<int>(draw.blend) != m_blend_state)
+    {
+        if (draw.blend)
+        {
+            glEnable(GL_BLEND);
+            // alpha adds up as coverage, so a gl_layer's texture ends up with premultiplied color
+            glBlendFuncSeparate(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA, GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+        } else
+        {
+            glDisable(GL_BLEND);
+        }
+        m_blend_state = draw.blend;
+        m_state_changes++;
+    }
+
+    // uniforms belong to the program, so the last color is remembered per program
+    m_program_state& program = get_program_state(draw.program);
+    if (!program.color_set || program.color != draw.color)
+    {
+        glUniform3f(program.color_location, draw.color[0], draw.color[1], draw.color[2]);
+        program.color = draw.color;
+        program.color_set = true;
+        m_state_changes++;
+    }
+    if (program.transform_location != -1 && (!program.transform_set || program.transform != draw.transform))
+    {
+        glUniform4f(program.transform_location, draw.transform[0], draw.transform[1], draw.transform[2],
+                    draw.transform[3]);
+        program.transform = draw.transform;
+        program.transform_set = true;
+        m_state_changes++;
+    }
+}
+
+gl_renderqueue::m_program_state& gl_renderqueue::get_program_state(unsigned int program)
+{
+    for (m_program_state& state: m_program_states)
+    {
+        if (state.program == program)
+        {
+            return state;
+        }
+        if (state.program == 0)
+        {
+            state.program = program;
+            state.color_location = glGetUniformLocation(program, "color");
+            state.transform_location = glGetUniformLocation(program, "transform");
+            return state;
+        }
+    }
+    log_error("RENDERQUEUE", "too many programs");
+    m_program_states.back() = {program, glGetUniformLocation(program, "color")};
+    m_program_states.back().transform_location = glGetUniformLocation(program, "transform");
+    return m_program_states.back();
+}
+
+bool gl_renderqueue::can_merge(const command& a, const command& b)
+{
+    // lines and triangle lists can simply be extended, strips and fans can't
+    bool list_mode = a.mode == GL_TRIANGLES || a.mode == GL_LINES || a.mode == GL_POINTS;
+    return list_mode && a.layer == b.layer && a.program == b.program && a.texture == b.texture &&
+           a.vao == b.vao && a.mode == b.mode && a.indexed == b.indexed && a.blend == b.blend &&
+           a.color == b.color && a.transform == b.transform && a.instances == 0 && b.instances == 0 && b.first == a.first + a.count;
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+// draw order between layers is fixed, inside a layer draws are grouped by program and texture
+enum class render_layer : std::uint8_t
+{
+    BACKGROUND, WORLD, HUD
+};
+
+/*
+ * Every module submits its draws here instead of calling GL itself.
+ * Each command carries a 64 bit sort key
+ *
+ *   layer (8) | program (12) | texture (12) | depth (32)
+ *
+ * where depth is the submission order. execute() radix sorts the keys,
+ * uploads the frame's vertices in one go, merges draws that continue each
+ * other and skips binds and uniform updates that wouldn't change anything.
+ * Things that overlap and must keep their order belong on different layers.
+ */
+class gl_renderqueue
+{
+public:
+    // vertex format of the shared stream: location 0 = position, location 1 = texture coordinates
+    struct vertex
+    {
+        glm::vec2 position;
+        glm::vec2 texture_coordinates;
+    };
+
+    struct command
+    {
+        render_layer layer = render_layer::WORLD;
+        unsigned int program = 0;
+        unsigned int texture = 0;
+        // 0 draws from the queue's vertex stream, anything else is a module owned VAO
+        unsigned int vao = 0;
+        GLenum mode = GL_TRIANGLES;
+        // vertices (or indices when indexed) to draw
+        std::uint32_t first = 0;
+        std::uint32_t count = 0;
+        bool indexed = false;
+        bool blend = false;
+        // above 0 the vertices are drawn that many times (not indexed), per instance attributes come from the VAO
+        std::uint32_t instances = 0;
+        // value of the program's "color" uniform
+        std::array<float, 3> color{};
+        // value of the program's "transform" uniform if it has one, scale in xy and offset in zw
+        std::array<float, 4> transform{1.0f, 1.0f, 0.0f, 0.0f};
+    };
+
+    gl_renderqueue();
+
+    ~gl_renderqueue() = default;
+
+    gl_renderqueue(const gl_renderqueue&) = delete;
+
+    gl_renderqueue& operator=(const gl_renderqueue&) = delete;
+
+    // room for count vertices in this frame's stream, first is where they start.
+    // the span is only valid until the next call
+    std::span<vertex> allocate_vertices(std::size_t count, std::uint32_t& first);
+
+    void submit(const command& draw);
+
+    // sorts and draws everything submitted this frame, then starts a new frame
+    void execute();
+
+    unsigned int get_draw_calls() const;
+
+    unsigned int get_state_changes() const;
+
+private:
+    struct m_sort_entry
+    {
+        std::uint64_t key;
+        std::uint32_t index;
+    };
+
+    struct m_program_state
+    {
+        unsigned int program = 0;
+        GLint color_location = -1;
+        std::array<float, 3> color{};
+        bool color_set = false;
+        GLint transform_location = -1;
+        std::array<float, 4> transform{};
+        bool transform_set = false;
+    };
+
+    void sort(std::span<m_sort_entry> entries, std::span<m_sort_entry> scratch);
+
+    void apply_state(const command& draw);
+
+    m_program_state& get_program_state(unsigned int program);
+
+    static bool can_merge(const command& a, const command& b);
+
+    std::vector<command> m_commands;
+    std::vector<vertex> m_vertices;
+    std::size_t m_vertex_count = 0;
+
+    gl_vertex_array m_vao;
+    gl_buffer m_vbo;
+    std::size_t m_vbo_capacity = 0;
+
+    // state of the last draw, to skip redundant binds
+    unsigned int m_bound_program = 0;
+    unsigned int m_bound_vao = 0;
+    unsigned int m_bound_texture = 0;
+    int m_blend_state = -1; // -1 unknown, 0 disabled, 1 enabled
+    std::array<m_program_state, 16> m_program_states{};
+
+    unsigned int m_draw_calls = 0;
+    unsigned int m_state_changes = 0;
+};
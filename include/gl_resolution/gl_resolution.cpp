@@ -0,0 +1,188 @@
+#include "gl_resolution.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+#include "Logger/Logger.h"
+
+gl_resolution::gl_resolution(unsigned int screen_width, unsigned int screen_height,
+                             const ShaderSource& shader_source, double budget_ms)
+        : m_width(screen_width),
+          m_height(screen_height),
+          m_budget_ms(budget_ms),
+          m_shader(shader_source),
+          m_texture("scaled scene"),
+          m_framebuffer("scaled scene")
+{
+    glm::mat4 projection = glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height);
+    glUseProgram(m_shader.get_shader_program());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader.get_shader_program(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(projection));
+    glUseProgram(0);
+
+    // full size, a scaled frame only uses its lower left corner
+    glBindTexture(GL_TEXTURE_2D, m_texture.get());
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glBindTexture(GL_TEXTURE_2D, 0);
+    m_texture.set_size(std::size_t(m_width) * m_height * 4);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer.get());
+    glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, m_texture.get(), 0);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        log_error("RESOLUTION", "scaled scene framebuffer is incomplete, keeping native resolution");
+        m_budget_ms = 0.0;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    glGenQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+gl_resolution::~gl_resolution()
+{
+    glDeleteQueries(static_cast<GLsizei>(m_queries.size()), m_queries.data());
+}
+
+void gl_resolution::begin_frame()
+{
+    read_timers();
+    // with every query still in flight this frame goes untimed rather than waiting
+    m_timing = m_queries_in_flight < m_queries.size();
+    if (m_timing)
+    {
+        glBeginQuery(GL_TIME_ELAPSED, m_queries[m_next_query]);
+    }
+
+    m_frames++;
+    m_scaled_frame = m_scale < 1.0f;
+    if (!m_scaled_frame)
+    {
+        return;
+    }
+    m_scaled_frames++;
+    glGetIntegerv(GL_VIEWPORT, m_viewport.data());
+    glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer.get());
+    glViewport(0, 0, static_cast<GLsizei>(std::lround(m_width * m_scale)),
+               static_cast<GLsizei>(std::lround(m_height * m_scale)));
+}
+
+void gl_resolution::end_scene(gl_renderqueue& queue)
+{
+    if (!m_scaled_frame)
+    {
+        return;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glViewport(m_viewport[0], m_viewport[1], m_viewport[2], m_viewport[3]);
+
+    // the scene is opaque, layer.frag passes it through unchanged. Past the scaled corner the texture still
+    // holds older, larger frames, the far edges stop at the last texel centre so filtering never reaches them
+    auto w = static_cast<float>(m_width);
+    auto h = static_cast<float>(m_height);
+    float u = (static_cast<float>(std::lround(m_width * m_scale)) - 0.5f) / w;
+    float v = (static_cast<float>(std::lround(m_height * m_scale)) - 0.5f) / h;
+    gl_renderqueue::command quad;
+    std::span<gl_renderqueue::vertex> vertices = queue.allocate_vertices(6, quad.first);
+    vertices[0] = {{0.0f, h}, {0.0f, v}};
+    vertices[1] = {{0.0f, 0.0f}, {0.0f, 0.0f}};
+    vertices[2] = {{w, 0.0f}, {u, 0.0f}};
+    vertices[3] = {{0.0f, h}, {0.0f, v}};
+    vertices[4] = {{w, 0.0f}, {u, 0.0f}};
+    vertices[5] = {{w, h}, {u, v}};
+
+    quad.layer = render_layer::BACKGROUND;
+    quad.program = m_shader.get_shader_program();
+    quad.texture = m_texture.get();
+    quad.count = 6;
+    queue.submit(quad);
+}
+
+void gl_resolution::end_frame()
+{
+    if (!m_timing)
+    {
+        return;
+    }
+    glEndQuery(GL_TIME_ELAPSED);
+    m_next_query = (m_next_query + 1) % m_queries.size();
+    m_queries_in_flight++;
+}
+
+float gl_resolution::get_scale() const
+{
+    return m_scaled_frame ? m_scale : 1.0f;
+}
+
+void gl_resolution::print_report() const
+{
+    std::cout << "resolution: " << m_scaled_frames << " of " << m_frames << " frames scaled";
+    if (m_scaled_frames > 0)
+    {
+        std::cout << ", down to " << m_lowest_scale << " over " << m_changes << " changes";
+    }
+    if (m_samples > 0)
+    {
+        std::cout << ", " << m_total_gpu_ms / static_cast<double>(m_samples) << " ms GPU time average";
+    }
+    if (m_budget_ms > 0.0)
+    {
+        std::cout << " against a " << m_budget_ms << " ms budget";
+    }
+    std::cout << std::endl;
+}
+
+void gl_resolution::read_timers()
+{
+    while (m_queries_in_flight > 0)
+    {
+        unsigned int query = m_queries[(m_next_query + m_queries.size() - m_queries_in_flight) % m_queries.size()];
+        GLint available = 0;
+        glGetQueryObjectiv(query, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available)
+        {
+            return;
+        }
+        GLuint64 nanoseconds = 0;
+        glGetQueryObjectui64v(query, GL_QUERY_RESULT, &nanoseconds);
+        m_queries_in_flight--;
+        update_scale(static_cast<double>(nanoseconds) * 1e-6);
+    }
+}
+
+void gl_resolution::update_scale(double gpu_ms)
+{
+    m_samples++;
+    m_total_gpu_ms += gpu_ms;
+    m_gpu_ms = m_samples == 1 ? gpu_ms : m_gpu_ms * 0.9 + gpu_ms * 0.1;
+    if (m_budget_ms <= 0.0 || ++m_samples_since_change < m_settle_samples)
+    {
+        return;
+    }
+
+    // aim a bit under the budget so the next spike still fits
+    double target = m_scale * std::sqrt(m_budget_ms * 0.85 / std::max(m_gpu_ms, 0.001));
+    double scale = m_scale;
+    if (m_gpu_ms > m_budget_ms)
+    {
+        scale = std::min(target, scale);
+    } else if (m_gpu_ms < m_budget_ms * 0.6)
+    {
+        // a little at a time on the way up, dropping again costs another settle
+        scale = std::min({target, scale * 1.1, 1.0});
+        scale = std::max(scale, static_cast<double>(m_scale));
+    }
+    // in 1/32 steps, so noise doesn't change the scale every time
+    auto next = static_cast<float>(std::clamp(std::round(scale * 32.0) / 32.0, static_cast<double>(min_scale), 1.0));
+    if (next != m_scale)
+    {
+        m_scale = next;
+        m_changes++;
+        m_samples_since_change = 0;
+        m_lowest_scale = std::min(m_lowest_scale, m_scale);
+    }
+}
@@ -0,0 +1,99 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include <glbinding/gl/gl.h>
+#include <glm/glm.hpp>
+#include "glm/gtc/matrix_transform.hpp"
+#include <glm/gtc/type_ptr.hpp>
+
+#include "Shader/Shader.h"
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
+
+using namespace gl;
+
+/*
+ * Dynamic resolution for the scene. Timer queries measure each frame's
+ * GPU time, read a few frames later so nothing waits on them. While it
+ * stays under the budget the scene is drawn straight into the window;
+ * past it, the scene goes into the corner of an offscreen texture at a
+ * fraction of the window's size and is stretched over the window under
+ * the HUD, which keeps drawing at native resolution. Pixels cost about
+ * the square of the scale, so the scale moves by the square root of how
+ * far the GPU time is off, and back up once there's room again.
+ *
+ *   resolution.begin_frame();
+ *   glClear(...);
+ *   scene_queue.execute();
+ *   resolution.end_scene(hud_queue);
+ *   hud_queue.execute();
+ *   resolution.end_frame();
+ */
+class gl_resolution
+{
+public:
+    static constexpr float min_scale = 0.5f;
+
+    // budget_ms 0 keeps native resolution, the GPU time is still measured and reported
+    gl_resolution(unsigned int screen_width, unsigned int screen_height, const ShaderSource& shader_source,
+                  double budget_ms);
+
+    ~gl_resolution();
+
+    gl_resolution(const gl_resolution&) = delete;
+
+    gl_resolution& operator=(const gl_resolution&) = delete;
+
+    // binds what the scene is drawn into this frame, clear it afterwards
+    void begin_frame();
+
+    // back to the window, the stretched scene goes under queue's HUD when it was scaled
+    void end_scene(gl_renderqueue& queue);
+
+    // after the HUD is drawn, ends the frame's timer query
+    void end_frame();
+
+    // of the frame begun last
+    float get_scale() const;
+
+    void print_report() const;
+
+private:
+    static constexpr std::size_t m_query_count = 4;
+    // samples after a change before the next one, the average needs to catch up
+    static constexpr std::uint32_t m_settle_samples = 30;
+
+    void read_timers();
+
+    void update_scale(double gpu_ms);
+
+    unsigned int m_width;
+    unsigned int m_height;
+    double m_budget_ms;
+    Shader m_shader;
+    gl_texture m_texture;
+    gl_framebuffer m_framebuffer;
+
+    std::array<unsigned int, m_query_count> m_queries{};
+    // queries are issued at m_next_query and read m_queries_in_flight behind it
+    std::size_t m_next_query = 0;
+    std::size_t m_queries_in_flight = 0;
+    bool m_timing = false;
+
+    float m_scale = 1.0f;
+    bool m_scaled_frame = false;
+    std::array<GLint, 4> m_viewport{};
+    double m_gpu_ms = 0.0;
+    std::uint32_t m_samples_since_change = 0;
+
+    std::uint64_t m_frames = 0;
+    std::uint64_t m_scaled_frames = 0;
+    std::uint64_t m_samples = 0;
+    double m_total_gpu_ms = 0.0;
+    std::uint64_t m_changes = 0;
+    float m_lowest_scale = 1.0f;
+};
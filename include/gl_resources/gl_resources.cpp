@@ -0,0 +1,182 @@
+#include "gl_resources.h"
+
+#include <algorithm>
+#include <iostream>
+
+#include <glbinding/gl/gl.h>
+
+#include "Logger/Logger.h"
+
+using namespace gl;
+
+const char* get_resource_type_name(gl_resource_type type)
+{
+    switch (type)
+    {
+        case gl_resource_type::BUFFER:
+            return "buffers";
+        case gl_resource_type::VERTEX_ARRAY:
+            return "vertex arrays";
+        case gl_resource_type::TEXTURE:
+            return "textures";
+        case gl_resource_type::PROGRAM:
+            return "programs";
+        case gl_resource_type::FRAMEBUFFER:
+            return "framebuffers";
+    }
+    return "unknown";
+}
+
+gl_resource_tracker::~gl_resource_tracker()
+{
+    print_leaks();
+}
+
+void gl_resource_tracker::on_create(gl_resource_type type, unsigned int id, const char* label)
+{
+    if (!m_records.try_emplace(make_key(type, id), m_record{type, id, label, 0}).second)
+    {
+        log_error("GL_RESOURCES", "{} reuses live id {}", label, id);
+        return;
+    }
+    m_counts[static_cast<std::size_t>(type)]++;
+}
+
+void gl_resource_tracker::on_delete(gl_resource_type type, unsigned int id)
+{
+    auto it = m_records.find(make_key(type, id));
+    if (it == m_records.end())
+    {
+        log_error("GL_RESOURCES", "deleting untracked id {}", id);
+        return;
+    }
+    m_counts[static_cast<std::size_t>(type)]--;
+    m_bytes[static_cast<std::size_t>(type)] -= it->second.bytes;
+    m_records.erase(it);
+}
+
+void gl_resource_tracker::set_size(gl_resource_type type, unsigned int id, std::size_t bytes)
+{
+    auto it = m_records.find(make_key(type, id));
+    if (it == m_records.end())
+    {
+        return;
+    }
+    std::size_t& total = m_bytes[static_cast<std::size_t>(type)];
+    total = total - it->second.bytes + bytes;
+    it->second.bytes = bytes;
+}
+
+void gl_resource_tracker::end_frame()
+{
+    for (std::size_t i = 0; i < gl_resource_type_count; i++)
+    {
+        // startup creates everything at once, the first frame only sets the baseline
+        if (m_counts[i] > m_frame_high[i] && !m_first_frame)
+        {
+            log_warning("GL_RESOURCES", "live {} grew from {} to {} ({} bytes)",
+                        get_resource_type_name(static_cast<gl_resource_type>(i)), m_frame_high[i], m_counts[i],
+                        m_bytes[i]);
+        }
+        m_frame_high[i] = std::max(m_frame_high[i], m_counts[i]);
+    }
+    m_first_frame = false;
+}
+
+std::size_t gl_resource_tracker::get_count(gl_resource_type type) const
+{
+    return m_counts[static_cast<std::size_t>(type)];
+}
+
+std::size_t gl_resource_tracker::get_bytes(gl_resource_type type) const
+{
+    return m_bytes[static_cast<std::size_t>(type)];
+}
+
+std::size_t gl_resource_tracker::get_total_count() const
+{
+    return m_records.size();
+}
+
+void gl_resource_tracker::print_report() const
+{
+    std::cout << "GL resources:" << std::endl;
+    for (std::size_t i = 0; i < gl_resource_type_count; i++)
+    {
+        std::cout << "  " << get_resource_type_name(static_cast<gl_resource_type>(i)) << ": " << m_counts[i]
+                  << " live, ~" << m_bytes[i] << " bytes" << std::endl;
+    }
+}
+
+void gl_resource_tracker::print_leaks() const
+{
+    if (m_records.empty())
+    {
+        return;
+    }
+    log_warning("GL_RESOURCES", "{} GL objects leaked", m_records.size());
+    for (const auto& [key, record]: m_records)
+    {
+        log_warning("GL_RESOURCES", "leaked {} {} \"{}\" ~{} bytes", get_resource_type_name(record.type), record.id,
+                    record.label, record.bytes);
+    }
+}
+
+std::uint64_t gl_resource_tracker::make_key(gl_resource_type type, unsigned int id)
+{
+    return (static_cast<std::uint64_t>(type) << 32) | id;
+}
+
+gl_resource_tracker& get_gl_resource_tracker()
+{
+    // statics go in reverse order, the logger made first is still there for the leaks at exit
+    get_logger();
+    static gl_resource_tracker tracker;
+    return tracker;
+}
+
+unsigned int create_gl_object(gl_resource_type type)
+{
+    unsigned int id = 0;
+    switch (type)
+    {
+        case gl_resource_type::BUFFER:
+            glGenBuffers(1, &id);
+            break;
+        case gl_resource_type::VERTEX_ARRAY:
+            glGenVertexArrays(1, &id);
+            break;
+        case gl_resource_type::TEXTURE:
+            glGenTextures(1, &id);
+            break;
+        case gl_resource_type::PROGRAM:
+            id = glCreateProgram();
+            break;
+        case gl_resource_type::FRAMEBUFFER:
+            glGenFramebuffers(1, &id);
+            break;
+    }
+    return id;
+}
+
+void delete_gl_object(gl_resource_type type, unsigned int id)
+{
+    switch (type)
+    {
+        case gl_resource_type::BUFFER:
+            glDeleteBuffers(1, &id);
+            break;
+        case gl_resource_type::VERTEX_ARRAY:
+            glDeleteVertexArrays(1, &id);
+            break;
+        case gl_resource_type::TEXTURE:
+            glDeleteTextures(1, &id);
+            break;
+        case gl_resource_type::PROGRAM:
+            glDeleteProgram(id);
+            break;
+        case gl_resource_type::FRAMEBUFFER:
+            glDeleteFramebuffers(1, &id);
+            break;
+    }
+}
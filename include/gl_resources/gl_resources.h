@@ -0,0 +1,160 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <utility>
+
+enum class gl_resource_type : std::uint8_t
+{
+    BUFFER, VERTEX_ARRAY, TEXTURE, PROGRAM, FRAMEBUFFER
+};
+
+constexpr std::size_t gl_resource_type_count = 5;
+
+const char* get_resource_type_name(gl_resource_type type);
+
+/*
+ * Knows every GL object created through a gl_handle, with a label and an
+ * estimate of the memory behind it. end_frame() warns when a category keeps
+ * climbing past its previous high, and whatever is still alive when the
+ * tracker goes away at exit is printed as a leak.
+ * GL objects only live on the GL thread, so neither does this.
+ */
+class gl_resource_tracker
+{
+public:
+    gl_resource_tracker() = default;
+
+    ~gl_resource_tracker();
+
+    gl_resource_tracker(const gl_resource_tracker&) = delete;
+
+    gl_resource_tracker& operator=(const gl_resource_tracker&) = delete;
+
+    // label must outlive the object, string literals are the intended use
+    void on_create(gl_resource_type type, unsigned int id, const char* label);
+
+    void on_delete(gl_resource_type type, unsigned int id);
+
+    // estimated bytes of storage, replaces the previous estimate
+    void set_size(gl_resource_type type, unsigned int id, std::size_t bytes);
+
+    void end_frame();
+
+    std::size_t get_count(gl_resource_type type) const;
+
+    std::size_t get_bytes(gl_resource_type type) const;
+
+    std::size_t get_total_count() const;
+
+    void print_report() const;
+
+    void print_leaks() const;
+
+private:
+    struct m_record
+    {
+        gl_resource_type type;
+        unsigned int id;
+        const char* label;
+        std::size_t bytes;
+    };
+
+    static std::uint64_t make_key(gl_resource_type type, unsigned int id);
+
+    std::unordered_map<std::uint64_t, m_record> m_records;
+    std::array<std::size_t, gl_resource_type_count> m_counts{};
+    std::array<std::size_t, gl_resource_type_count> m_bytes{};
+    // highest count seen at an end_frame(), growth past it is reported
+    std::array<std::size_t, gl_resource_type_count> m_frame_high{};
+    bool m_first_frame = true;
+};
+
+// tracker for the GL thread's context, its leak report runs when the program exits
+gl_resource_tracker& get_gl_resource_tracker();
+
+unsigned int create_gl_object(gl_resource_type type);
+
+void delete_gl_object(gl_resource_type type, unsigned int id);
+
+/*
+ * Move-only owner of one GL object. Constructing it with a label creates
+ * and registers the object, destruction deletes and unregisters it.
+ */
+template<gl_resource_type Type>
+class gl_handle
+{
+public:
+    gl_handle() = default;
+
+    explicit gl_handle(const char* label)
+            : m_id(create_gl_object(Type))
+    {
+        get_gl_resource_tracker().on_create(Type, m_id, label);
+    }
+
+    // takes ownership of an object created elsewhere, like a linked program
+    static gl_handle adopt(unsigned int id, const char* label)
+    {
+        gl_handle handle;
+        handle.m_id = id;
+        get_gl_resource_tracker().on_create(Type, id, label);
+        return handle;
+    }
+
+    ~gl_handle()
+    {
+        reset();
+    }
+
+    gl_handle(const gl_handle&) = delete;
+
+    gl_handle& operator=(const gl_handle&) = delete;
+
+    gl_handle(gl_handle&& other) noexcept
+            : m_id(std::exchange(other.m_id, 0))
+    {
+
+    }
+
+    gl_handle& operator=(gl_handle&& other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            m_id = std::exchange(other.m_id, 0);
+        }
+        return *this;
+    }
+
+    unsigned int get() const
+    {
+        return m_id;
+    }
+
+    void set_size(std::size_t bytes) const
+    {
+        get_gl_resource_tracker().set_size(Type, m_id, bytes);
+    }
+
+    void reset()
+    {
+        if (m_id != 0)
+        {
+            get_gl_resource_tracker().on_delete(Type, m_id);
+            delete_gl_object(Type, m_id);
+            m_id = 0;
+        }
+    }
+
+private:
+    unsigned int m_id = 0;
+};
+
+using gl_buffer = gl_handle<gl_resource_type::BUFFER>;
+using gl_vertex_array = gl_handle<gl_resource_type::VERTEX_ARRAY>;
+using gl_texture = gl_handle<gl_resource_type::TEXTURE>;
+using gl_program = gl_handle<gl_resource_type::PROGRAM>;
+using gl_framebuffer = gl_handle<gl_resource_type::FRAMEBUFFER>;
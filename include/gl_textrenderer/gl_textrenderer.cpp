@@ -1,72 +1,46 @@
 #include "gl_textrenderer.h"
 
-gl_textrenderer::gl_textrenderer(unsigned int screen_width, unsigned int screen_height, std::string font_path,
-                                 int pixel_height, std::array<float, 4> colors)
-        : m_font_path(font_path),
-          m_projection(glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height)),
-          m_colors(colors)
-{
-    std::string vertex_shader = R"(
-        #version 330 core
-        layout (location = 0) in vec2 position;
-        layout (location = 1) in vec4 texture_coordinates;
-
-        out vec2 TexCoords;
+#include <algorithm>
 
-        uniform mat4 projection;
+#include "Logger/Logger.h"
 
-        void main()
-        {
-            gl_Position = projection * vec4(position.xy, 0.0, 1.0);
-            TexCoords = texture_coordinates.xy;
-        }
-    )";
-
-    std::string fragment_shader = R"(
-        #version 330 core
-        in vec2 TexCoords;
-        out vec4 color;
-
-        uniform sampler2D text; // mono-colored bitmap image of the glyph
-        uniform vec3 textColor; // color uniform for adjusting the text's final color
-
-        void main()
-        {
-            // we sample the 'r'ed component of the texture
-            // because thats where the texture's data is stored
-            // we put that value is the alpha value
-            // so that background pixels will be 0 (transparent)
-            // and character pixels will be visible (1)
-            vec4 sampled = vec4(1.0, 1.0, 1.0, texture(text, TexCoords).r);
-            color = vec4(textColor, 1.0) * sampled;
-        }
-    )";
-
-    m_shader_program = create_shader_program(vertex_shader, fragment_shader);
-    load_ascii_characters(pixel_height);
+gl_textrenderer::gl_textrenderer(unsigned int screen_width, unsigned int screen_height, const glyph_atlas& atlas,
+                                 const ShaderSource& shader_source, std::array<float, 4> colors)
+        : m_projection(glm::ortho(0.0f, (float) screen_width, 0.0f, (float) screen_height)),
+          m_characters(atlas.characters),
+          m_colors(colors)
+{
+    m_shader_program = gl_program::adopt(
+            create_shader_program(shader_source.get_vertex(), shader_source.get_fragment()), "text shader");
+    upload_atlas(atlas);
+
+    // the projection never changes, the color goes through the render queue
+    glUseProgram(m_shader_program.get());
+    glUniformMatrix4fv(glGetUniformLocation(m_shader_program.get(), "projection"), 1, GL_FALSE,
+                       glm::value_ptr(m_projection));
+    glUseProgram(0);
 }
 
 gl_textrenderer::~gl_textrenderer()
 {
-    glDeleteProgram(m_shader_program);
+
 }
 
-// FIXME: very inefficient
-void gl_textrenderer::render_text(std::string text, float x, float y)
+void gl_textrenderer::render_text(gl_renderqueue& queue, std::string_view text, float x, float y,
+                                  render_layer layer)
 {
-    glEnable(GL_BLEND);
-    glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-    glUseProgram(m_shader_program);
-    glUniformMatrix4fv(glGetUniformLocation(m_shader_program, "projection"), 1, GL_FALSE, glm::value_ptr(m_projection));
-    glUniform3f(glGetUniformLocation(m_shader_program, "textColor"), m_colors[0], m_colors[1], m_colors[2]);
+    if (text.empty())
+    {
+        return;
+    }
+    // every glyph's two triangles go into the queue's stream as one draw, they all sample the same atlas
+    std::uint32_t first;
+    std::span<gl_renderqueue::vertex> vertices = queue.allocate_vertices(text.size() * 6, first);
 
     int first_bearing_x = 0;
-    for (char c: text)
+    for (std::size_t i = 0; i < text.size(); i++)
     {
-        m_character ch = m_characters[c];
-        glActiveTexture(GL_TEXTURE0);
-        glBindTexture(GL_TEXTURE_2D, ch.TextureID);
+        m_character ch = get_character(text[i]);
 
         /*
          * This removes the bearingX of the first character,
@@ -100,87 +74,70 @@ void gl_textrenderer::render_text(std::string text, float x, float y)
          *   xpos + width
          * FREETYPE GLYPHS ARE REVERSED: 0,0  = top left
          * */
-        std::vector<m_vertex> vertices = {};
-        std::vector<unsigned int> indices = {
-                0, 1, 2, // first triangle
-                1, 2, 3  // second triangle
-        };
-
-        m_vertex v0 = {};
-        v0.position = {xpos, ypos};
-        v0.texture_coordinates =  {0.0f, 1.0f};
-        vertices.push_back(v0);
-
-        m_vertex v1 = {};
-        v1.position = {xpos + width, ypos};
-        v1.texture_coordinates =  {1.0f, 1.0f};
-        vertices.push_back(v1);
-
-        m_vertex v2 = {};
-        v2.position = {xpos, ypos + height};
-        v2.texture_coordinates =  {0.0f, 0.0f};
-        vertices.push_back(v2);
-
-        m_vertex v3 = {};
-        v3.position = {xpos + width, ypos + height};
-        v3.texture_coordinates =  {1.0f, 0.0f};
-        vertices.push_back(v3);
-
-        unsigned int VAO, VBO, EBO;
-
-        glGenVertexArrays(1, &VAO);
-        glBindVertexArray(VAO);
-
-        glGenBuffers(1, &VBO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBO);
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(m_vertex), vertices.data(), GL_STATIC_DRAW);
-
-        glGenBuffers(1, &EBO);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), indices.data(), GL_STATIC_DRAW);
-
-        glEnableVertexAttribArray(0);
-        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, sizeof(m_vertex), (const void*)offsetof(m_vertex, position));
-
-        glEnableVertexAttribArray(1);
-        glVertexAttribPointer(1, 2, GL_FLOAT, GL_FALSE, sizeof(m_vertex), (const void*)offsetof(m_vertex, texture_coordinates));
-
-        // render quad
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, nullptr);
+        gl_renderqueue::vertex bottom_left = {{xpos, ypos}, {ch.UvMin.x, ch.UvMax.y}};
+        gl_renderqueue::vertex bottom_right = {{xpos + width, ypos}, {ch.UvMax.x, ch.UvMax.y}};
+        gl_renderqueue::vertex top_left = {{xpos, ypos + height}, {ch.UvMin.x, ch.UvMin.y}};
+        gl_renderqueue::vertex top_right = {{xpos + width, ypos + height}, {ch.UvMax.x, ch.UvMin.y}};
+        gl_renderqueue::vertex* quad = &vertices[i * 6];
+        quad[0] = bottom_left;  // first triangle
+        quad[1] = bottom_right;
+        quad[2] = top_left;
+        quad[3] = bottom_right; // second triangle
+        quad[4] = top_left;
+        quad[5] = top_right;
 
         x += (ch.Advance >> 6);
-
-        glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
-        glBindVertexArray(0);
-        glBindTexture(GL_TEXTURE_2D, 0);
     }
-    glUseProgram(0);
+
+    gl_renderqueue::command draw;
+    draw.layer = layer;
+    draw.program = m_shader_program.get();
+    draw.texture = m_atlas_texture.get();
+    draw.first = first;
+    draw.count = static_cast<std::uint32_t>(vertices.size());
+    draw.blend = true;
+    draw.color = {m_colors[0], m_colors[1], m_colors[2]};
+    queue.submit(draw);
 }
 
-void gl_textrenderer::load_ascii_characters(int pixel_height)
+gl_textrenderer::glyph_atlas gl_textrenderer::rasterize_font(std::span<const std::byte> font_data, int pixel_height)
 {
-    // initialize freetype
+    glyph_atlas atlas;
+
+    // initialize freetype, every call gets its own library so threads don't share state
     FT_Library ft;
     if (FT_Init_FreeType(&ft))
     {
-        std::cout << "ERROR::FREETYPE: Could not init FreeType Library" << std::endl;
-        return;
+        log_error("FREETYPE", "Could not init FreeType Library");
+        return atlas;
     }
 
-    // load the font
+    // load the font straight from the mapped asset pack, freetype doesn't copy it
     FT_Face face;
-    if (FT_New_Face(ft, m_font_path.c_str(), 0, &face))
+    if (FT_New_Memory_Face(ft, reinterpret_cast<const FT_Byte*>(font_data.data()),
+                           static_cast<FT_Long>(font_data.size()), 0, &face))
     {
-        std::cout << "ERROR::FREETYPE: Failed to load font" << std::endl;
-        return;
+        log_error("FREETYPE", "Failed to load font");
+        FT_Done_FreeType(ft);
+        return atlas;
     }
 
     // set the pixel size
     FT_Set_Pixel_Sizes(face, 0, pixel_height);
 
-    // disable byte-alignment restriction
-    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    /*
+     * glyphs are packed into rows (shelves) of a fixed width atlas,
+     * with a pixel of padding so linear filtering doesn't bleed
+     * into the neighbouring glyph
+     * */
+    constexpr int atlas_width = 512;
+    constexpr int padding = 1;
+    std::array<glm::ivec2, 128> positions{};
+    std::vector<unsigned char> bitmaps;
+    std::array<std::size_t, 128> bitmap_offsets{};
+    int pen_x = padding;
+    int pen_y = padding;
+    int row_height = 0;
 
     // load first 128 characters of ASCII set
     for (unsigned char c = 0; c < 128; c++)
@@ -188,64 +145,106 @@ void gl_textrenderer::load_ascii_characters(int pixel_height)
         // Load ascii character with char code 0
         if (FT_Load_Char(face, c, FT_LOAD_RENDER))
         {
-            std::cout << "ERROR::FREETYTPE: Failed to load Glyph" << std::endl;
+            log_error("FREETYPE", "Failed to load glyph {}", c);
             continue;
         }
-        // generate texture
-        unsigned int texture;
-        glGenTextures(1, &texture);
-        glBindTexture(GL_TEXTURE_2D, texture);
-        /*
-         * set internal format and format to GL_RED
-         * because the bitmap generated by freetype
-         * is an 8-bit image where where each color
-         * is represented by a single bytes (8 bit).
-         * That's why we store each byte of of the
-         * bitmap buffer as the texture's single
-         * color value.
-         * we create a texture where each byte
-         * corresponds to the texture color's
-         * red component
-         * (first byte of its color vector)
-         * */
-        glTexImage2D(
-                GL_TEXTURE_2D,
-                0,
-                GL_RED, // set internal format to gl_red
-                face->glyph->bitmap.width,
-                face->glyph->bitmap.rows,
-                0,
-                GL_RED, // set format to gl_red
-                GL_UNSIGNED_BYTE,
-                face->glyph->bitmap.buffer
-        );
-        // set texture options
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-        // store character in a map for later use
-        m_character character = {
-                texture,
-                glm::ivec2(face->glyph->bitmap.width, face->glyph->bitmap.rows),
+        const FT_Bitmap& bitmap = face->glyph->bitmap;
+        int width = static_cast<int>(bitmap.width);
+        int rows = static_cast<int>(bitmap.rows);
+        if (pen_x + width + padding > atlas_width)
+        {
+            pen_x = padding;
+            pen_y += row_height + padding;
+            row_height = 0;
+        }
+        positions[c] = {pen_x, pen_y};
+        pen_x += width + padding;
+        row_height = std::max(row_height, rows);
+
+        // keep the bitmap until the atlas size is known, freetype reuses its buffer
+        bitmap_offsets[c] = bitmaps.size();
+        for (int row = 0; row < rows; row++)
+        {
+            const unsigned char* source = bitmap.buffer + row * bitmap.pitch;
+            bitmaps.insert(bitmaps.end(), source, source + width);
+        }
+
+        atlas.characters[c] = {
+                glm::ivec2(width, rows),
                 glm::ivec2(face->glyph->bitmap_left, face->glyph->bitmap_top),
                 static_cast<unsigned int>(face->glyph->advance.x)
         };
-        m_characters.insert(std::pair<char, m_character>(c, character));
     }
-    glBindTexture(GL_TEXTURE_2D, 0);
+
+    atlas.width = atlas_width;
+    atlas.height = pen_y + row_height + padding;
+    atlas.pixels.assign(static_cast<std::size_t>(atlas.width) * atlas.height, 0);
+    for (unsigned char c = 0; c < 128; c++)
+    {
+        m_character& ch = atlas.characters[c];
+        for (int row = 0; row < ch.Size.y; row++)
+        {
+            const unsigned char* source = bitmaps.data() + bitmap_offsets[c] + row * ch.Size.x;
+            std::copy(source, source + ch.Size.x,
+                      atlas.pixels.begin() + (positions[c].y + row) * atlas.width + positions[c].x);
+        }
+        ch.UvMin = glm::vec2(positions[c]) / glm::vec2(atlas.width, atlas.height);
+        ch.UvMax = glm::vec2(positions[c] + ch.Size) / glm::vec2(atlas.width, atlas.height);
+    }
 
     // destroy FreeType once we're finished
     FT_Done_Face(face);
     FT_Done_FreeType(ft);
+    return atlas;
+}
+
+void gl_textrenderer::upload_atlas(const glyph_atlas& atlas)
+{
+    // disable byte-alignment restriction
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    m_atlas_texture = gl_texture("glyph atlas");
+    glBindTexture(GL_TEXTURE_2D, m_atlas_texture.get());
+    /*
+     * set internal format and format to GL_RED
+     * because the bitmap generated by freetype
+     * is an 8-bit image where where each color
+     * is represented by a single bytes (8 bit).
+     * That's why we store each byte of of the
+     * bitmap buffer as the texture's single
+     * color value.
+     * we create a texture where each byte
+     * corresponds to the texture color's
+     * red component
+     * (first byte of its color vector)
+     * */
+    glTexImage2D(
+            GL_TEXTURE_2D,
+            0,
+            GL_RED, // set internal format to gl_red
+            atlas.width,
+            atlas.height,
+            0,
+            GL_RED, // set format to gl_red
+            GL_UNSIGNED_BYTE,
+            atlas.pixels.data()
+    );
+    m_atlas_texture.set_size(atlas.pixels.size());
+    // set texture options
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glBindTexture(GL_TEXTURE_2D, 0);
 }
 
-unsigned int gl_textrenderer::create_shader_program(std::string& vertex_src, std::string& fragment_src)
+unsigned int gl_textrenderer::create_shader_program(std::string_view vertex_src, std::string_view fragment_src)
 {
     // vertex shader
     unsigned int vertexShader = glCreateShader(GL_VERTEX_SHADER);
-    const char* c_str_vertex = vertex_src.c_str();
-    glShaderSource(vertexShader, 1, &c_str_vertex, nullptr);
+    const char* c_str_vertex = vertex_src.data();
+    GLint vertex_length = static_cast<GLint>(vertex_src.size());
+    glShaderSource(vertexShader, 1, &c_str_vertex, &vertex_length);
     glCompileShader(vertexShader);
     // check for shader compile errors
     int success;
@@ -254,19 +253,20 @@ unsigned int gl_textrenderer::create_shader_program(std::string& vertex_src, std
     if (!success)
     {
         glGetShaderInfoLog(vertexShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::VERTEX::COMPILATION_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::VERTEX::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // fragment shader
     unsigned int fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
-    const char* c_str_fragment = fragment_src.c_str();
-    glShaderSource(fragmentShader, 1, &c_str_fragment, nullptr);
+    const char* c_str_fragment = fragment_src.data();
+    GLint fragment_length = static_cast<GLint>(fragment_src.size());
+    glShaderSource(fragmentShader, 1, &c_str_fragment, &fragment_length);
     glCompileShader(fragmentShader);
     // check for shader compile errors
     glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &success);
     if (!success)
     {
         glGetShaderInfoLog(fragmentShader, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::FRAGMENT::COMPILATION_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::FRAGMENT::COMPILATION_FAILED", "\n{}", infoLog);
     }
     // link shaders
     unsigned int shaderProgram = glCreateProgram();
@@ -278,7 +278,7 @@ unsigned int gl_textrenderer::create_shader_program(std::string& vertex_src, std
     if (!success)
     {
         glGetProgramInfoLog(shaderProgram, 512, nullptr, infoLog);
-        std::cout << "ERROR::SHADER::PROGRAM::LINKING_FAILED\n" << infoLog << std::endl;
+        log_error("SHADER::PROGRAM::LINKING_FAILED", "\n{}", infoLog);
     }
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
@@ -286,23 +286,25 @@ unsigned int gl_textrenderer::create_shader_program(std::string& vertex_src, std
     return shaderProgram;
 }
 
-std::pair<int, int> gl_textrenderer::get_text_size(std::string text)
+const gl_textrenderer::m_character& gl_textrenderer::get_character(char c) const
+{
+    // only the first 128 ASCII characters are loaded
+    return m_characters[static_cast<unsigned char>(c) & 127];
+}
+
+std::pair<int, int> gl_textrenderer::get_text_size(std::string_view text)
 {
     int textWidth = 0;
     int textHeight = 0;
-    int count = 0;
     for (char c : text)
     {
-        m_character ch = m_characters[c];
+        const m_character& ch = get_character(c);
         // pick the biggest height in the text
         if (ch.Size.y > textHeight)
         {
             textHeight = ch.Size.y;
         }
         textWidth += ch.Advance >> 6;
-        count++;
     }
     return {textWidth, textHeight};
 }
-
-
@@ -10,48 +10,68 @@
 #include <ft2build.h>
 #include FT_FREETYPE_H
 
+#include <array>
 #include <iostream>
-#include <map>
+#include <span>
+#include <string_view>
+#include <vector>
+
+#include "ShaderSource/ShaderSource.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "gl_resources/gl_resources.h"
 
 using namespace gl;
 
 class gl_textrenderer
 {
-public:
-    gl_textrenderer(unsigned int screen_width, unsigned int screen_height, std::string font_path, int pixel_height,
-                    std::array<float, 4> colors);
-
-    ~gl_textrenderer();
-
-    void render_text(std::string text, float x, float y);
-
-    std::pair<int, int> get_text_size(std::string text);
-
 private:
-    struct m_vertex
-    {
-        glm::vec2 position;
-        glm::vec2 texture_coordinates;
-    };
     struct m_character
     {
-        unsigned int TextureID;  // opengl texture ID of the glyph
         glm::ivec2 Size;       // Size of glyph (width and height of bitmap)
         // bearing.x horizontal position relative to the origin
         // bearing.y vertical position relative to the baseline
         glm::ivec2 Bearing;    // Offset from baseline to left/top of glyph
         // horizontal distance in 1/64th pixels from the origin to the next origin
         unsigned int Advance;    // Offset to advance to next glyph
+        glm::vec2 UvMin;       // top left of the glyph inside the atlas
+        glm::vec2 UvMax;       // bottom right of the glyph inside the atlas
     };
 
-    void load_ascii_characters(int pixel_height);
+public:
+    // first 128 ASCII glyphs rasterized into one 8-bit bitmap, not yet on the GPU
+    struct glyph_atlas
+    {
+        int width = 0;
+        int height = 0;
+        std::vector<unsigned char> pixels;
+        std::array<m_character, 128> characters{};
+    };
+
+    // CPU only, safe to call on a worker thread before the GL context exists
+    static glyph_atlas rasterize_font(std::span<const std::byte> font_data, int pixel_height);
+
+    // only uploads, the atlas and shader source were prepared ahead of time
+    gl_textrenderer(unsigned int screen_width, unsigned int screen_height, const glyph_atlas& atlas,
+                    const ShaderSource& shader_source, std::array<float, 4> colors);
+
+    ~gl_textrenderer();
+
+    void render_text(gl_renderqueue& queue, std::string_view text, float x, float y,
+                     render_layer layer = render_layer::HUD);
+
+    std::pair<int, int> get_text_size(std::string_view text);
+
+private:
+    void upload_atlas(const glyph_atlas& atlas);
+
+    const m_character& get_character(char c) const;
 
-    unsigned int create_shader_program(std::string& vertex_src, std::string& fragment_src);
+    unsigned int create_shader_program(std::string_view vertex_src, std::string_view fragment_src);
 
-    std::string m_font_path;
     glm::mat4 m_projection;
-    std::map<char, m_character> m_characters;
+    std::array<m_character, 128> m_characters{};
     std::array<float, 4> m_colors;
 
-    unsigned int m_shader_program;
+    gl_program m_shader_program;
+    gl_texture m_atlas_texture;
 };
@@ -1,4 +1,14 @@
+#include <cassert>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <functional>
 #include <iostream>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
 #include <GLFW/glfw3.h>
 #include <glbinding/glbinding.h>
 #include <glbinding/gl/gl.h>
@@ -9,230 +19,1503 @@
 #include "Rectangle/Rectangle.h"
 #include "Triangle/Triangle.h"
 #include "Line/Line.h"
+#include "JumpEnv/JumpEnv.h"
+#include "FrameArena/FrameArena.h"
+#include "FixedText/FixedText.h"
+#include "AllocCounter/AllocCounter.h"
+#include "AssetPack/AssetPack.h"
+#include "ShaderSource/ShaderSource.h"
+#include "StartupGraph/StartupGraph.h"
+#include "Level/Level.h"
+#include "gl_renderqueue/gl_renderqueue.h"
+#include "ParticleSystem/ParticleSystem.h"
+#include "gl_particles/gl_particles.h"
+#include "gl_resources/gl_resources.h"
+#include "FrameStats/FrameStats.h"
+#include "gl_perfoverlay/gl_perfoverlay.h"
+#include "GameState/GameState.h"
+#include "UdpSocket/UdpSocket.h"
+#include "RollbackSession/RollbackSession.h"
+#include "StateHistory/StateHistory.h"
+#include "GhostSystem/GhostSystem.h"
+#include "gl_ghosts/gl_ghosts.h"
+#include "gl_obstacles/gl_obstacles.h"
+#include "gl_primitives/gl_primitives.h"
+#include "FrameEncoder/FrameEncoder.h"
+#include "gl_capture/gl_capture.h"
+#include "gl_backend/gl_backend.h"
+#include "gl_layer/gl_layer.h"
+#include "gl_resolution/gl_resolution.h"
+#include "TimingWheel/TimingWheel.h"
+#include "ScriptRunner/ScriptRunner.h"
+#include "Logger/Logger.h"
+#include "Collision/Collision.h"
 
 using namespace gl;
 
 const unsigned int SCREEN_WIDTH = 500;
 const unsigned int SCREEN_HEIGHT = 500;
 
-bool check_collision_x(int rectangle_front, int rectangle_back,
-                       int triangle_front, int triangle_back);
+bool has_flag(int argc, char** argv, std::string_view flag);
 
-bool check_collision_y(int rectangle_bottom);
+// index of flag in argv, 0 when it isn't there
+int find_flag(int argc, char** argv, std::string_view flag);
 
-bool is_space_key_pressed(GLFWwindow* window);
+// the whole argument as a finite number, nothing if it isn't one
+std::optional<double> parse_number(std::string_view text);
 
-enum GAME_STATE
+// the whole argument as a count, nothing if it isn't one
+std::optional<std::size_t> parse_count(std::string_view text);
+
+int run_env_benchmark(int argc, char** argv);
+
+int run_particle_benchmark(int argc, char** argv);
+
+int run_ghost_benchmark(int argc, char** argv);
+
+int run_render_benchmark(int argc, char** argv);
+
+int run_timer_benchmark(int argc, char** argv);
+
+int run_script_benchmark(int argc, char** argv);
+
+// ramps up the scene in a window until frames go over budget, writing the curve as CSV
+int run_stress_test(int argc, char** argv);
+
+// what the scripts change on screen, they run on game ticks but never touch the GameState
+struct script_visuals
 {
-    START, GAME, END
+    bool crash_flash = false;
+    std::string_view prompt;
 };
 
-int main()
+// the first run explains the controls
+script tutorial_prompts(ScriptRunner& runner, script_visuals& visuals);
+
+// the square flashes for a moment after a crash
+script crash_flash(ScriptRunner& runner, script_visuals& visuals);
+
+// random presses for count runs of up to max_ticks ticks, stand-ins for recorded ones
+void add_bot_ghosts(GhostSystem& ghosts, std::size_t count, std::uint32_t max_ticks, std::uint64_t seed);
+
+int main(int argc, char** argv)
 {
+    // --log <file> writes diagnostics there instead of stderr
+    if (int log_flag = find_flag(argc, argv, "--log"); log_flag && log_flag + 1 < argc)
+    {
+        get_logger().open_file(argv[log_flag + 1]);
+    }
+
+    // headless modes, no window needed
+    if (argc > 1 && std::string_view(argv[1]) == "--env-bench")
+    {
+        return run_env_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--particle-bench")
+    {
+        return run_particle_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--ghost-bench")
+    {
+        return run_ghost_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--render-bench")
+    {
+        return run_render_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--timer-bench")
+    {
+        return run_timer_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--script-bench")
+    {
+        return run_script_benchmark(argc, argv);
+    }
+    if (argc > 1 && std::string_view(argv[1]) == "--stress")
+    {
+        return run_stress_test(argc, argv);
+    }
+
+    AssetPack assets;
+    bool assets_loaded = false;
+    gl_textrenderer::glyph_atlas font_atlas;
+    ShaderSource shape_source;
+    ShaderSource text_source;
+    ShaderSource particle_source;
+    ShaderSource ghost_source;
+    ShaderSource obstacle_source;
+    ShaderSource primitive_source;
+    ShaderSource layer_source;
+    Level level;
+    // --level <file.level> plays an authored course, see gl_jump_level
+    int level_flag = find_flag(argc, argv, "--level");
+
+    // CPU only startup work runs on workers while the window comes up. Declared after everything its tasks
+    // touch, so on an early return the graph waits for its workers before any of that is destroyed
+    StartupGraph startup(3);
+
+    auto open_assets = startup.add_task("open asset pack", [&]
+    {
+        // fonts and shaders, built by the gl_jump_pack target
+        assets_loaded = assets.open("assets/gl_jump.pack");
+    });
+    auto rasterize_font = startup.add_task("rasterize font", [&]
+    {
+        if (assets_loaded)
+        {
+            font_atlas = gl_textrenderer::rasterize_font(assets.get("UbuntuMono-R.ttf"), 13);
+        }
+    }, {open_assets});
+    auto preprocess_shaders = startup.add_task("preprocess shaders", [&]
+    {
+        if (assets_loaded)
+        {
+            shape_source = ShaderSource::load(assets, "shape");
+            text_source = ShaderSource::load(assets, "text");
+            particle_source = ShaderSource::load(assets, "particle");
+            ghost_source = ShaderSource::load(assets, "ghost");
+            obstacle_source = ShaderSource::load(assets, "obstacle");
+            primitive_source = ShaderSource::load(assets, "primitive");
+            layer_source = ShaderSource::load(assets, "layer");
+        }
+    }, {open_assets});
+    auto generate = startup.add_task("load level", [&]
+    {
+        if (level_flag && level_flag + 1 < argc && level.open(argv[level_flag + 1]))
+        {
+            return;
+        }
+        level = generate_level(1, 4096);
+    });
+    startup.start();
+
+    auto step_begin = StartupGraph::clock::now();
     if (!glfwInit()) return -1;
+    // declared before every GL object, so whichever way main returns they're destroyed with the context alive
+    struct glfw_session
+    {
+        ~glfw_session()
+        {
+            glfwTerminate();
+        }
+    } glfw;
     glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    // the training workload for PGO builds runs in a hidden window on a build server
+    bool train = has_flag(argc, argv, "--train");
+    glfwWindowHint(GLFW_VISIBLE, train ? GLFW_FALSE : GLFW_TRUE);
+    // --capture <out.y4m> records every frame, stepping a tick per frame as fast as it can draw
+    int capture_flag = find_flag(argc, argv, "--capture");
+    bool capture = capture_flag && capture_flag + 1 < argc;
+    // a tick per frame instead of the clock
+    bool fixed_step = train || capture;
     GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT,
                                           "gl_jump", nullptr, nullptr);
     if (!window)
     {
-        glfwTerminate();
         return -1;
     }
     glfwMakeContextCurrent(window);
 
     glbinding::initialize(glfwGetProcAddress);
+    if (fixed_step)
+    {
+        glfwSwapInterval(0);
+    }
+    startup.record("create window and context", step_begin);
+
+    startup.wait(preprocess_shaders);
+    if (!assets_loaded)
+    {
+        return -1;
+    }
 
-    Shader shader;
+    step_begin = StartupGraph::clock::now();
+    Shader shader(shape_source);
     unsigned int shaderProgram = shader.get_shader_program();
     glUseProgram(shaderProgram);
     glm::mat4 projection = glm::ortho(0.0f, (float) SCREEN_WIDTH, 0.0f,
                                       (float) SCREEN_HEIGHT);
     glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1,
                        GL_FALSE, glm::value_ptr(projection));
-    glUniform3f(glGetUniformLocation(shaderProgram, "color"), 0.0f, 0.5f, 0.5f);
+    // the squares, triangles and the ground line, from meshes built at compile time
+    gl_primitives primitives(SCREEN_WIDTH, SCREEN_HEIGHT, primitive_source);
+    startup.record("compile shape shaders", step_begin);
 
     // frame timing
     double delta_time = 0.0f;
     double last_frame = 0.0f;
 
-    Triangle triangle(50, 50, SCREEN_WIDTH, 100);
-    Triangle bg_triangle(rand() % 8 * 100 + 200, rand() % 8 * 100 + 200,
-                         triangle.triangle_pos_x + 550,
-                         triangle.triangle_pos_y);
+    startup.wait(generate);
+    // everything the simulation touches, advanced in fixed ticks
+    GameState game = make_game_state(level, SCREEN_WIDTH);
+    double tick_accumulator = 0.0;
+    // every tick of the last minute or so, holding R rewinds through it at double speed
+    StateHistory history(32 * 1024, 60);
+    history.record(game);
+    bool rewound = false;
 
-    Rectangle rectangle(60, 60, 100, 100);
+    // --race <local port> <remote port> [latency ms] [jitter ms] [loss %]
+    // races another gl_jump on 127.0.0.1, the lower port is player one
+    std::optional<UdpSocket> race_socket;
+    std::optional<RollbackSession> race;
+    int local_player = 0;
+    if (int race_flag = find_flag(argc, argv, "--race"))
+    {
+        // the optional ones are taken up to the next flag
+        auto race_argument = [&](int offset) -> std::string_view
+        {
+            return race_flag + offset < argc && argv[race_flag + offset][0] != '-' ? argv[race_flag + offset] : "";
+        };
+        std::optional<std::size_t> local_port = parse_count(race_argument(1));
+        std::optional<std::size_t> remote_port = parse_count(race_argument(2));
+        // no conditions unless they're given
+        std::optional<double> latency = race_argument(3).empty() ? 0.0 : parse_number(race_argument(3));
+        std::optional<double> jitter = race_argument(4).empty() ? 0.0 : parse_number(race_argument(4));
+        std::optional<double> loss = race_argument(5).empty() ? 0.0 : parse_number(race_argument(5));
+        if (!local_port || *local_port == 0 || *local_port > 65535 ||
+            !remote_port || *remote_port == 0 || *remote_port > 65535 ||
+            !latency || *latency < 0.0 || !jitter || *jitter < 0.0 || !loss || *loss < 0.0 || *loss > 100.0)
+        {
+            std::cout << "usage: gl_jump --race <local port> <remote port> [latency ms] [jitter ms] [loss %]"
+                      << std::endl;
+            return -1;
+        }
+        network_conditions conditions;
+        conditions.latency_ms = *latency;
+        conditions.jitter_ms = *jitter;
+        conditions.loss = *loss / 100.0;
+        local_player = *local_port < *remote_port ? 0 : 1;
+
+        race_socket.emplace();
+        if (!race_socket->open(static_cast<std::uint16_t>(*local_port), static_cast<std::uint16_t>(*remote_port)))
+        {
+            return -1;
+        }
+        race_socket->set_conditions(conditions, static_cast<std::uint16_t>(*local_port));
+        race.emplace(level, SCREEN_WIDTH, local_player, *race_socket);
+    }
 
     Line line;
 
-    gl_textrenderer textrenderer(SCREEN_WIDTH, SCREEN_HEIGHT,
-                                 "assets/UbuntuMono-R.ttf", 13,
-                                 {1.0f, 1.0f, 1.0f, 1.1f});
+    startup.wait(rasterize_font);
+    step_begin = StartupGraph::clock::now();
+    gl_textrenderer textrenderer(SCREEN_WIDTH, SCREEN_HEIGHT, font_atlas,
+                                 text_source, {1.0f, 1.0f, 1.0f, 1.1f});
+    startup.record("upload glyph atlas", step_begin);
 
-    int score = 0;
-    int current_game_state = GAME_STATE::START;
-    int prev_space_state = GLFW_RELEASE;
+    // every draw goes through here, sorted by layer, program and texture.
+    // the scene's go into render_queue, text and overlays into hud_queue
+    gl_renderqueue render_queue;
+    gl_renderqueue hud_queue;
+
+    // the scene drops below native resolution when its GPU time goes over --gpu-budget <ms>, the HUD never does.
+    // recordings and the training run stay native, they should come out the same anywhere
+    double gpu_budget_ms = fixed_step ? 0.0 : 12.0;
+    if (int budget_flag = find_flag(argc, argv, "--gpu-budget"); budget_flag && budget_flag + 1 < argc)
+    {
+        std::optional<double> budget = parse_number(argv[budget_flag + 1]);
+        if (budget && *budget >= 0.0)
+        {
+            gpu_budget_ms = *budget;
+        } else
+        {
+            log_error("MAIN", "--gpu-budget takes milliseconds, 0 or more, not {}", argv[budget_flag + 1]);
+        }
+    }
+    gl_resolution resolution(SCREEN_WIDTH, SCREEN_HEIGHT, layer_source, gpu_budget_ms);
+
+    // what rarely changes is drawn into a layer's texture when it does, the frame draws the texture.
+    // the ground line and the title screen change with the game state,
+    // the score and the prompts at most once a tick
+    gl_renderqueue layer_queue;
+    gl_layer static_layer(SCREEN_WIDTH, SCREEN_HEIGHT, layer_source, "static layer");
+    gl_layer hud_layer(SCREEN_WIDTH, SCREEN_HEIGHT, layer_source, "hud layer");
+
+    // dust, bursts and trails, they fall onto the line at y 100
+    ParticleSystem particles(16384, 600.0f, 100.0f);
+    gl_particles particle_renderer(SCREEN_WIDTH, SCREEN_HEIGHT, particle_source, particles.get_capacity());
+    Random particle_random{3};
+    ParticleEmitter landing_dust;
+    landing_dust.position_spread = {30.0f, 0.0f};
+    landing_dust.velocity = {-60.0f, 60.0f};
+    landing_dust.velocity_spread = {80.0f, 40.0f};
+    landing_dust.life = 0.4f;
+    landing_dust.life_spread = 0.15f;
+    landing_dust.size = 3.0f;
+    landing_dust.color = {0.6f, 0.6f, 0.6f};
+    ParticleEmitter collision_burst;
+    collision_burst.position_spread = {10.0f, 10.0f};
+    collision_burst.velocity = {0.0f, 250.0f};
+    collision_burst.velocity_spread = {250.0f, 200.0f};
+    collision_burst.life = 0.8f;
+    collision_burst.life_spread = 0.3f;
+    collision_burst.size = 4.0f;
+    collision_burst.color = {0.9f, 0.4f, 0.1f};
+    ParticleEmitter speed_trail;
+    speed_trail.position_spread = {0.0f, 25.0f};
+    speed_trail.velocity_spread = {20.0f, 10.0f};
+    speed_trail.life = 0.25f;
+    speed_trail.life_spread = 0.05f;
+    speed_trail.size = 2.0f;
+    speed_trail.color = {0.2f, 0.4f, 0.9f};
+
+    // every finished run comes back as a ghost, --ghosts <count> adds that many bots on top
+    std::size_t bot_ghosts = 0;
+    if (int ghosts_flag = find_flag(argc, argv, "--ghosts"); ghosts_flag && ghosts_flag + 1 < argc)
+    {
+        std::optional<std::size_t> count = parse_count(argv[ghosts_flag + 1]);
+        if (count)
+        {
+            bot_ghosts = *count;
+        } else
+        {
+            log_error("MAIN", "--ghosts takes a count, not {}", argv[ghosts_flag + 1]);
+        }
+    }
+    GhostSystem ghosts(bot_ghosts + 256);
+    gl_ghosts ghost_renderer(SCREEN_WIDTH, SCREEN_HEIGHT, ghost_source, ghosts.get_capacity(), {60.0f, 60.0f});
+    add_bot_ghosts(ghosts, bot_ghosts, 60 * 60, 9);
+    // obstacles are uploaded when they spawn and moved by obstacle.vert, --cpu-obstacles
+    // streams them through the queue every frame instead, to compare against
+    gl_obstacles obstacle_renderer(SCREEN_WIDTH, SCREEN_HEIGHT, obstacle_source);
+    bool cpu_obstacles = has_flag(argc, argv, "--cpu-obstacles");
+    // ten minutes of the current run, ghosts count their ticks from its start.
+    // when run_logged, the log holds the inputs of the run that started on logged_run_start.
+    // a rewind into an earlier run leaves nothing whole to keep as a ghost
+    InputLog current_run(60 * 60 * 10);
+    bool run_logged = false;
+    std::uint32_t logged_run_start = 0;
+
+    // sequences spread over ticks, started by game events
+    ScriptRunner scripts;
+    script_visuals visuals;
+    bool tutorial_shown = false;
+    bool prev_script_space = false;
 
     auto title_text_size = textrenderer.get_text_size("gl_jump");
     auto start_text_size = textrenderer.get_text_size(
             "press [ space ] to start");
 
-    srand(1);
+    FixedText<32> score_text;
+    FixedText<32> rival_text;
+    FixedText<48> rewind_text;
+
+    // F3 toggles it, --overlay starts with it shown
+    FrameStats frame_stats;
+    gl_perfoverlay perf_overlay(SCREEN_WIDTH, SCREEN_HEIGHT, shaderProgram);
+    bool show_overlay = has_flag(argc, argv, "--overlay");
+    // --report prints the startup timeline, and at exit what each system counted
+    bool report = has_flag(argc, argv, "--report");
+    int prev_overlay_key_state = GLFW_RELEASE;
+    double sim_ms = 0.0;
+    FrameAllocations frame_allocations;
+    // GAME frames since the first run ended. Until the next run is a few frames in, caches may still warm up
+    // and the driver may still compile a program on its first draw: bursts start with a crash, ghosts with a run
+    int game_frames = 0;
+
+    // --train plays itself for train_frames frames on a fixed timestep and input script,
+    // going through the start screen, jumps, collisions and the overlay text
+    const std::size_t train_frames = 3000;
+    std::size_t frame_index = 0;
+    int collisions = 0;
+    if (train)
+    {
+        show_overlay = true;
+    }
+
+    // once the title screen settles nothing is drawn until input, the window needs repainting or
+    // the wake timer fires. races keep polling the network and --train must draw every frame
+    const double idle_wake_seconds = 1.0;
+    bool can_idle = !race && !fixed_step;
+
+    std::optional<FrameEncoder> encoder;
+    std::optional<gl_capture> capturer;
+    if (capture)
+    {
+        encoder.emplace(SCREEN_WIDTH, SCREEN_HEIGHT, static_cast<unsigned int>(1.0 / game_tick_seconds + 0.5));
+        if (!encoder->open(argv[capture_flag + 1]))
+        {
+            return -1;
+        }
+        capturer.emplace(SCREEN_WIDTH, SCREEN_HEIGHT, *encoder);
+    }
+    bool idle = false;
+    bool window_damaged = false;
+    std::uint64_t presented_scene = 0;
+    std::uint64_t idle_waits = 0;
+    double idle_seconds = 0.0;
+    glfwSetWindowUserPointer(window, &window_damaged);
+    glfwSetWindowRefreshCallback(window, [](GLFWwindow* damaged_window)
+    {
+        *static_cast<bool*>(glfwGetWindowUserPointer(damaged_window)) = true;
+    });
+
+    bool first_frame = true;
+    step_begin = StartupGraph::clock::now();
+    last_frame = glfwGetTime();
     while (!glfwWindowShouldClose(window))
     {
-        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        frame_allocations.begin_frame();
+        get_frame_arena().reset();
+
+        if (idle)
+        {
+            double wait_begin = glfwGetTime();
+            glfwWaitEventsTimeout(idle_wake_seconds);
+            idle_waits++;
+            idle_seconds += glfwGetTime() - wait_begin;
+            // the wait isn't game time, but whatever woke us gets one tick to act on the input
+            last_frame = glfwGetTime() - game_tick_seconds;
+            idle = false;
+        }
 
         double current_frame = glfwGetTime();
         delta_time = current_frame - last_frame;
         last_frame = current_frame;
-
-        std::string score_text = "score: " + std::to_string(score);
-        auto score_text_size = textrenderer.get_text_size(score_text);
+        if (fixed_step)
+        {
+            delta_time = game_tick_seconds;
+        }
+        // after a long stall, catch up a few ticks instead of fast forwarding
+        tick_accumulator = std::min(tick_accumulator + delta_time, game_tick_seconds * 8);
 
         int curr_space_state = glfwGetKey(window, GLFW_KEY_SPACE);
+        if (train)
+        {
+            // a short press every 47 frames, sometimes clears the triangle and sometimes doesn't.
+            // racing players are out of phase so their games differ
+            curr_space_state = (frame_index + 23 * local_player) % 47 < 3 ? GLFW_PRESS : GLFW_RELEASE;
+        }
+        // rewinding is for practice, a race can't go back
+        bool rewinding = !race && glfwGetKey(window, GLFW_KEY_R) == GLFW_PRESS;
+        if (train)
+        {
+            rewinding = !race && frame_index >= 1500 && frame_index < 1620;
+        }
+        int curr_overlay_key_state = glfwGetKey(window, GLFW_KEY_F3);
+        if (curr_overlay_key_state == GLFW_PRESS && prev_overlay_key_state == GLFW_RELEASE)
+        {
+            show_overlay = !show_overlay;
+        }
+        prev_overlay_key_state = curr_overlay_key_state;
 
-        switch (current_game_state)
+        // update
+        // -------------------------------------------
+        auto sim_begin = std::chrono::steady_clock::now();
+        while (tick_accumulator >= game_tick_seconds)
         {
-            case GAME_STATE::START:
-                // update
-                // -------------------------------------------
-                // don't allow game to restart
-                // if player was previously holding space
-                if (curr_space_state == GLFW_PRESS &&
-                    prev_space_state == GLFW_RELEASE)
-                {
-                    rectangle.jump_state = is_space_key_pressed(window);
+            tick_accumulator -= game_tick_seconds;
+            game_events events;
+            if (rewinding)
+            {
+                std::uint32_t target = std::max(game.tick, history.get_first_tick() + 2) - 2;
+                history.seek(target, game);
+                rewound = true;
+                continue;
+            }
+            if (rewound)
+            {
+                // play on from the rewound tick, what came after it is gone
+                history.truncate(game.tick);
+                if (run_logged && logged_run_start == game.run_start_tick)
+                {
+                    current_run.truncate(game.tick - game.run_start_tick);
+                } else
+                {
+                    current_run.clear();
+                    run_logged = false;
                 }
-                if (rectangle.jump_state)
+                rewound = false;
+            }
+            if (race)
+            {
+                // a tick spent waiting for the peer is simply skipped
+                if (!race->advance(curr_space_state == GLFW_PRESS, events))
                 {
-                    rectangle.jump();
-                    if (rectangle.rectangle_pos_y <= 100)
-                    {
-                        current_game_state = GAME_STATE::GAME;
-                        score = 0;
-                    }
+                    continue;
                 }
+            } else
+            {
+                events = step_game(game, curr_space_state == GLFW_PRESS, level, SCREEN_WIDTH);
+                history.record(game);
+            }
+
+            const GameState& player = race ? race->get_local() : game;
+            const Rectangle& rectangle = player.rectangle;
+            scripts.tick({curr_space_state == GLFW_PRESS && !prev_script_space, events.collided});
+            prev_script_space = curr_space_state == GLFW_PRESS;
+            if (events.started && !tutorial_shown)
+            {
+                scripts.start(tutorial_prompts(scripts, visuals));
+                tutorial_shown = true;
+            }
+            if (events.collided)
+            {
+                scripts.start(crash_flash(scripts, visuals));
+            }
+            if (events.started)
+            {
+                current_run.clear();
+                run_logged = true;
+                logged_run_start = player.run_start_tick;
+            } else if (run_logged && (player.current_game_state == GAME_STATE::GAME || events.collided))
+            {
+                current_run.push(curr_space_state == GLFW_PRESS);
+            }
+            if (events.collided && run_logged)
+            {
+                ghosts.add(current_run.get_words(), current_run.get_tick_count());
+            }
+            if (events.landed)
+            {
+                landing_dust.position = {rectangle.rectangle_pos_x + rectangle.rectangle_width / 2,
+                                         rectangle.rectangle_pos_y};
+                particles.emit(landing_dust, 48, particle_random);
+            }
+            if (events.collided)
+            {
+                // the triangle is already back at the right edge, burst where it was hit
+                collision_burst.position = {rectangle.rectangle_pos_x + rectangle.rectangle_width,
+                                            rectangle.rectangle_pos_y};
+                particles.emit(collision_burst, 256, particle_random);
+                collisions++;
+            }
+            if (player.current_game_state == GAME_STATE::GAME)
+            {
+                speed_trail.position = {rectangle.rectangle_pos_x,
+                                        rectangle.rectangle_pos_y + rectangle.rectangle_height / 2};
+                speed_trail.velocity = {-(300.0f + player.score), 0.0f};
+                particles.emit(speed_trail, 4, particle_random);
+            }
+        }
+        const GameState& player = race ? race->get_local() : game;
+        if (player.current_game_state == GAME_STATE::GAME)
+        {
+            ghosts.seek(player.tick - player.run_start_tick);
+        }
+        sim_ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - sim_begin).count();
 
-                // draw
-                // -------------------------------------------
-                rectangle.draw(shaderProgram, 0.0f, 0.2f, 0.7f);
-                line.draw(shaderProgram, 1.0f, 1.0f, 1.0f, 0, 100,
-                          SCREEN_WIDTH, 100);
+        // draw
+        // -------------------------------------------
+        score_text.clear();
+        score_text.append("score: ").append(player.score);
+        auto score_text_size = textrenderer.get_text_size(score_text.view());
 
-                textrenderer.render_text("gl_jump",
+        // the scene only depends on the state and the text, the tick count, held keys and timers don't show.
+        // the wheel's clock moves every tick, even on the title screen
+        GameState shown = player;
+        shown.tick = 0;
+        shown.prev_space = false;
+        shown.timers = game_timers{};
+        std::uint64_t scene = hash_game_state(shown) ^ std::hash<std::string_view>{}(score_text.view()) ^
+                              std::hash<std::string_view>{}(visuals.prompt) ^ visuals.crash_flash;
+        bool scene_settled = can_idle && !show_overlay && !rewound && particles.get_count() == 0 &&
+                             scripts.get_timed() == 0 &&
+                             player.current_game_state == GAME_STATE::START && !player.rectangle.jump_state;
+        if (scene_settled && scene == presented_scene && !window_damaged)
+        {
+            // what's on screen is still right, skip the frame and sleep
+            idle = true;
+            continue;
+        }
+        presented_scene = scene;
+        window_damaged = false;
+
+        if (race)
+        {
+            // the rival's square, behind ours
+            Rectangle rival = race->get_remote().rectangle;
+            rival.draw(render_queue, render_layer::WORLD, primitives, 0.5f, 0.3f, 0.6f);
+            rival_text.clear();
+            rival_text.append("rival: ").append(race->get_remote().score);
+            textrenderer.render_text(hud_queue, rival_text.view(), 10, SCREEN_HEIGHT - 35);
+        }
+
+        if (rewound)
+        {
+            rewind_text.clear();
+            rewind_text.append("rewind -").append((history.get_last_tick() - game.tick) * game_tick_seconds, 1)
+                    .append(" s  seek ")
+                    .append(std::chrono::duration<double, std::micro>(history.get_last_seek_time()).count(), 2)
+                    .append(" us");
+            textrenderer.render_text(hud_queue, rewind_text.view(), 10, SCREEN_HEIGHT - 35);
+        }
+
+        Rectangle rectangle = player.rectangle;
+        Triangle triangle = player.triangle;
+        Triangle bg_triangle = player.bg_triangle;
+        obstacle_renderer.set(0, bg_triangle);
+        obstacle_renderer.set(1, triangle);
+        // between ticks the shader carries the motion on, a rewind holds still
+        obstacle_renderer.set_ticks(static_cast<float>(player.score) +
+                                    (rewinding ? 0.0f : static_cast<float>(tick_accumulator / game_tick_seconds)));
+        if (cpu_obstacles)
+        {
+            triangle.triangle_pos_x = triangle.position_at(player.score);
+            bg_triangle.triangle_pos_x = bg_triangle.position_at(player.score);
+        }
+        switch (player.current_game_state)
+        {
+            case GAME_STATE::START:
+                if (visuals.crash_flash)
+                {
+                    rectangle.draw(render_queue, render_layer::WORLD, primitives, 0.9f, 0.4f, 0.1f);
+                } else
+                {
+                    rectangle.draw(render_queue, render_layer::WORLD, primitives, 0.0f, 0.2f, 0.7f);
+                }
+                break;
+            case GAME_STATE::GAME:
+                if (cpu_obstacles)
+                {
+                    bg_triangle.draw(render_queue, render_layer::BACKGROUND, primitives, 0.13f, 0.13f, 0.13f);
+                    triangle.draw(render_queue, render_layer::WORLD, primitives, 0.7f, 0.2f, 0.0f);
+                } else
+                {
+                    obstacle_renderer.draw(render_queue, 0, render_layer::BACKGROUND, 0.13f, 0.13f, 0.13f);
+                    obstacle_renderer.draw(render_queue, 1, render_layer::WORLD, 0.7f, 0.2f, 0.0f);
+                }
+                ghost_renderer.draw(render_queue, ghosts, 0.4f, 0.6f, 1.0f);
+                rectangle.draw(render_queue, render_layer::WORLD, primitives, 0.0f, 0.2f, 0.7f);
+                break;
+        }
+
+        bool title_screen = player.current_game_state == GAME_STATE::START;
+        std::uint64_t static_key = static_cast<std::uint64_t>(player.current_game_state);
+        if (title_screen && player.score > 0)
+        {
+            static_key ^= std::hash<std::string_view>{}(score_text.view()) << 8;
+        }
+        if (static_layer.is_stale(static_key))
+        {
+            line.draw(layer_queue, render_layer::WORLD, primitives, 1.0f, 1.0f, 1.0f, 0, 100, SCREEN_WIDTH, 100);
+            if (title_screen)
+            {
+                textrenderer.render_text(layer_queue, "gl_jump",
                                          SCREEN_WIDTH / 2 -
                                          (title_text_size.first / 2),
                                          (SCREEN_HEIGHT -
                                           SCREEN_HEIGHT / 3) -
                                          (title_text_size.second / 2) + 2
                 );
-                textrenderer.render_text("press [ space ] to start",
+                textrenderer.render_text(layer_queue, "press [ space ] to start",
                                          SCREEN_WIDTH / 2 -
                                          (start_text_size.first / 2),
                                          (SCREEN_HEIGHT -
                                           SCREEN_HEIGHT / 2.6) -
                                          (start_text_size.second / 2) + 2
                 );
-                if (score > 0)
-                {
-                    textrenderer.render_text(score_text,
-                                             SCREEN_WIDTH / 2 -
-                                             (score_text_size.first / 2),
-                                             (SCREEN_HEIGHT -
-                                              SCREEN_HEIGHT / 2.4) -
-                                             (score_text_size.second / 2) +
-                                             2
-                    );
-                }
-                break;
-            case GAME_STATE::GAME:
-                // update
-                // -------------------------------------------
-                score += 1;
-                // allow the player to hold space by not checking prev state
-                if (curr_space_state == GLFW_PRESS)
-                {
-                    rectangle.jump_state = is_space_key_pressed(window);
-                }
-                if (rectangle.jump_state)
-                {
-                    rectangle.jump();
-                }
-
-                triangle.update_position(score, delta_time, SCREEN_WIDTH,
-                                         -((rand() % 50) * 100) - 200);
-                bg_triangle.update_position(score, delta_time, SCREEN_WIDTH,
-                                            -(bg_triangle.triangle_width * 3));
-
-                // randomize background triangle size
-                if (bg_triangle.triangle_pos_x <
-                    -(bg_triangle.triangle_width * 3))
-                {
-                    bg_triangle.triangle_height = rand() % 5 * 100 + 200;
-                    bg_triangle.triangle_width = rand() % 8 * 100 + 200;
-                }
+            }
+            if (title_screen && player.score > 0)
+            {
+                textrenderer.render_text(layer_queue, score_text.view(),
+                                         SCREEN_WIDTH / 2 -
+                                         (score_text_size.first / 2),
+                                         (SCREEN_HEIGHT -
+                                          SCREEN_HEIGHT / 2.4) -
+                                         (score_text_size.second / 2) +
+                                         2
+                );
+            }
+            static_layer.render(layer_queue, static_key);
+        }
+        // drawn over the world, the line used to be drawn after the square anyway
+        static_layer.draw(hud_queue, render_layer::HUD);
 
-                if (check_collision_x(
-                        rectangle.rectangle_pos_x + rectangle.rectangle_width,
-                        rectangle.rectangle_pos_x, triangle.triangle_pos_x,
-                        triangle.triangle_pos_x + triangle.triangle_width)
-                    && check_collision_y(rectangle.rectangle_pos_y))
-                {
-                    rectangle.jump_state = false;
-                    bg_triangle.triangle_pos_x = SCREEN_WIDTH + 550;
-                    triangle.triangle_pos_x = SCREEN_WIDTH;
-                    current_game_state = GAME_STATE::START;
-                }
+        std::uint64_t hud_key = std::hash<std::string_view>{}(visuals.prompt);
+        if (!title_screen)
+        {
+            hud_key = hud_key * 31 + std::hash<std::string_view>{}(score_text.view());
+        }
+        if (hud_layer.is_stale(hud_key))
+        {
+            if (!title_screen)
+            {
+                textrenderer.render_text(layer_queue, score_text.view(), 10, SCREEN_HEIGHT - 20);
+            }
+            if (!visuals.prompt.empty())
+            {
+                auto prompt_size = textrenderer.get_text_size(visuals.prompt);
+                // under the line, clear of the square and the overlay
+                textrenderer.render_text(layer_queue, visuals.prompt, SCREEN_WIDTH / 2 - (prompt_size.first / 2),
+                                         50);
+            }
+            hud_layer.render(layer_queue, hud_key);
+        }
+        hud_layer.draw(hud_queue, render_layer::HUD);
 
-                // draw
-                // -------------------------------------------
-                bg_triangle.draw(shaderProgram, 0.13f, 0.13f, 0.13f);
-                rectangle.draw(shaderProgram, 0.0f, 0.2f, 0.7f);
-                triangle.draw(shaderProgram, 0.7f, 0.2f, 0.0f);
-                line.draw(shaderProgram, 1.0f, 1.0f, 1.0f, 0, 100,
-                          SCREEN_WIDTH, 100);
+        // bursts keep playing out after the game state changed
+        particles.update(static_cast<float>(delta_time));
+        particle_renderer.draw(render_queue, particles);
 
-                textrenderer.render_text(score_text, 10,
-                                         SCREEN_HEIGHT - 20);
-                break;
+        if (show_overlay)
+        {
+            perf_overlay.draw(hud_queue, textrenderer, frame_stats);
         }
-        prev_space_state = curr_space_state;
 
+        resolution.begin_frame();
+        particle_renderer.set_point_scale(resolution.get_scale());
+        glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+        render_queue.execute();
+        resolution.end_scene(hud_queue);
+        hud_queue.execute();
+        resolution.end_frame();
+        // a GAME frame, submitted and drawn, must not touch the heap once warmed up
+        if (allocation_counting_enabled && collisions > 0 && player.current_game_state == GAME_STATE::GAME &&
+            ++game_frames > 3)
+        {
+            assert(frame_allocations.get_count() == 0);
+        }
+        // warns when GL objects pile up over time
+        get_gl_resource_tracker().end_frame();
+        frame_stats.record({static_cast<float>(delta_time * 1000.0), static_cast<float>(sim_ms),
+                            render_queue.get_draw_calls() + hud_queue.get_draw_calls(),
+                            static_cast<std::uint32_t>(get_gl_resource_tracker().get_total_count())});
+        if (capturer)
+        {
+            capturer->capture_frame();
+        }
         glfwSwapBuffers(window);
         glfwPollEvents();
+
+        if (train && ++frame_index == train_frames)
+        {
+            std::cout << "training run: " << frame_index << " frames, " << collisions << " collisions" << std::endl;
+            if (race)
+            {
+                race->print_stats();
+            }
+            glfwSetWindowShouldClose(window, GLFW_TRUE);
+        }
+
+        if (first_frame)
+        {
+            first_frame = false;
+            startup.record("first frame", step_begin);
+            if (report)
+            {
+                startup.print_timeline();
+            }
+        }
     }
 
+    if (race && !train)
+    {
+        race->print_stats();
+    }
+    if (capturer)
+    {
+        capturer->finish();
+        encoder->close();
+        capturer->print_report();
+        encoder->print_report();
+    }
+    if (report)
+    {
+        if (!race)
+        {
+            history.print_report();
+        }
+        obstacle_renderer.print_report();
+        static_layer.print_report();
+        hud_layer.print_report();
+        resolution.print_report();
+        scripts.print_report();
+        if (idle_waits > 0)
+        {
+            std::cout << "idle: " << idle_seconds << " s on a settled screen over " << idle_waits << " waits"
+                      << std::endl;
+        }
+        // what's live before main's GL objects go, anything left after them is logged as a leak
+        get_gl_resource_tracker().print_report();
+    }
     return 0;
 }
 
-bool check_collision_x(int rectangle_front, int rectangle_back,
-                       int triangle_front, int triangle_back)
+bool has_flag(int argc, char** argv, std::string_view flag)
 {
-    if (rectangle_front >= triangle_front && rectangle_back <= triangle_back)
+    return find_flag(argc, argv, flag) != 0;
+}
+
+int find_flag(int argc, char** argv, std::string_view flag)
+{
+    for (int i = 1; i < argc; i++)
     {
-        return true;
+        if (flag == argv[i])
+        {
+            return i;
+        }
     }
-    return false;
+    return 0;
 }
 
-bool check_collision_y(int rectangle_bottom)
+std::optional<double> parse_number(std::string_view text)
 {
-    if (rectangle_bottom <= 135)
+    double value = 0.0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size() || !std::isfinite(value))
     {
-        return true;
+        return std::nullopt;
     }
-    return false;
+    return value;
 }
 
+std::optional<std::size_t> parse_count(std::string_view text)
+{
+    std::size_t value = 0;
+    auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+    if (error != std::errc() || end != text.data() + text.size())
+    {
+        return std::nullopt;
+    }
+    return value;
+}
 
-bool is_space_key_pressed(GLFWwindow* window)
+// gl_jump --env-bench [instances] [steps]
+int run_env_benchmark(int argc, char** argv)
 {
-    if (glfwGetKey(window, GLFW_KEY_SPACE) == GLFW_PRESS)
+    std::optional<std::size_t> instances_given = argc > 2 ? parse_count(argv[2]) : 16384;
+    std::optional<std::size_t> steps_given = argc > 3 ? parse_count(argv[3]) : 1000;
+    if (!instances_given || *instances_given == 0 || !steps_given)
     {
-        return true;
+        std::cout << "usage: gl_jump --env-bench [instances, more than 0] [steps]" << std::endl;
+        return -1;
     }
-    return false;
-}
\ No newline at end of file
+    std::size_t instance_count = *instances_given;
+    std::size_t step_count = *steps_given;
+
+    // the course the game generates when it isn't given one
+    Level level = generate_level(1, 4096);
+    JumpEnv env(instance_count, level, 1, SCREEN_WIDTH);
+    std::vector<std::uint8_t> actions(instance_count);
+    std::vector<float> observations(instance_count * JumpEnv::observation_size);
+    std::vector<float> rewards(instance_count);
+    std::vector<std::uint8_t> dones(instance_count);
+
+    env.reset(observations.data());
+    Random policy{7};
+    for (std::size_t step = 0; step < step_count; step++)
+    {
+        // jump at random, about once every 30 ticks per instance
+        for (std::uint8_t& action: actions)
+        {
+            action = policy.next_int(30) == 0;
+        }
+        env.step(actions.data(), observations.data(), rewards.data(), dones.data());
+    }
+    env.print_throughput();
+    return 0;
+}
+
+// gl_jump --particle-bench [particles] [frames]
+int run_particle_benchmark(int argc, char** argv)
+{
+    std::optional<std::size_t> particles_given = argc > 2 ? parse_count(argv[2]) : 100000;
+    std::optional<std::size_t> frames_given = argc > 3 ? parse_count(argv[3]) : 1000;
+    if (!particles_given || !frames_given || *frames_given == 0)
+    {
+        std::cout << "usage: gl_jump --particle-bench [particles] [frames, more than 0]" << std::endl;
+        return -1;
+    }
+    std::size_t particle_count = *particles_given;
+    std::size_t frame_count = *frames_given;
+
+    // CPU side of a frame: integrate, compact and write the vertex stream
+    ParticleSystem particles(particle_count, 600.0f, 100.0f);
+    std::vector<ParticleSystem::vertex> vertices(particle_count);
+    Random random{5};
+    ParticleEmitter emitter;
+    emitter.position = {250.0f, 300.0f};
+    emitter.position_spread = {250.0f, 200.0f};
+    emitter.velocity_spread = {200.0f, 200.0f};
+    emitter.life = 2.0f;
+    emitter.life_spread = 1.0f;
+
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration worst{};
+    for (std::size_t frame = 0; frame < frame_count; frame++)
+    {
+        // top up whatever expired, so every frame runs at the full count
+        particles.emit(emitter, particle_count - particles.get_count(), random);
+
+        auto start = std::chrono::steady_clock::now();
+        particles.update(1.0f / 60.0f);
+        particles.write_vertices(vertices);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+    }
+    std::cout << particle_count << " particles: "
+              << std::chrono::duration<double, std::milli>(total).count() / frame_count << " ms average, "
+              << std::chrono::duration<double, std::milli>(worst).count() << " ms worst per frame" << std::endl;
+    return 0;
+}
+
+void add_bot_ghosts(GhostSystem& ghosts, std::size_t count, std::uint32_t max_ticks, std::uint64_t seed)
+{
+    Random random{seed};
+    std::vector<std::uint64_t> inputs((max_ticks + 63) / 64);
+    for (std::size_t i = 0; i < count; i++)
+    {
+        auto ticks = static_cast<std::uint32_t>(max_ticks / 4 + random.next_int(static_cast<int>(max_ticks * 3 / 4)));
+        std::fill(inputs.begin(), inputs.end(), 0);
+        for (std::uint32_t tick = 0; tick < ticks; tick++)
+        {
+            if (random.next_int(40) == 0)
+            {
+                inputs[tick / 64] |= std::uint64_t(1) << (tick % 64);
+            }
+        }
+        ghosts.add({inputs.data(), (ticks + 63) / 64}, ticks);
+    }
+}
+
+// gl_jump --ghost-bench [ghosts] [frames]
+int run_ghost_benchmark(int argc, char** argv)
+{
+    std::optional<std::size_t> ghosts_given = argc > 2 ? parse_count(argv[2]) : 1000;
+    std::optional<std::size_t> frames_given = argc > 3 ? parse_count(argv[3]) : 8000;
+    if (!ghosts_given || !frames_given || *frames_given == 0)
+    {
+        std::cout << "usage: gl_jump --ghost-bench [ghosts] [frames, more than 0]" << std::endl;
+        return -1;
+    }
+    std::size_t ghost_count = *ghosts_given;
+    std::size_t frame_count = *frames_given;
+
+    GhostSystem ghosts(ghost_count);
+    add_bot_ghosts(ghosts, ghost_count, 60 * 60, 9);
+    std::vector<glm::vec2> corners(ghost_count);
+
+    // CPU side of a 144 FPS frame: advance to the current tick and write the instances
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration worst{};
+    for (std::size_t frame = 0; frame < frame_count; frame++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        ghosts.seek(static_cast<std::uint32_t>(frame * 60 / 144));
+        ghosts.write_instances(corners);
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+    }
+
+    // after a rewind every ghost replays its run from the start
+    ghosts.seek(0);
+    auto start = std::chrono::steady_clock::now();
+    ghosts.seek(60 * 60);
+    auto replay = std::chrono::steady_clock::now() - start;
+
+    std::cout << ghost_count << " ghosts: "
+              << std::chrono::duration<double, std::milli>(total).count() / frame_count << " ms average, "
+              << std::chrono::duration<double, std::milli>(worst).count() << " ms worst per frame, "
+              << std::chrono::duration<double, std::milli>(replay).count() << " ms to replay a minute" << std::endl;
+    return 0;
+}
+
+// what the recording backend must see for the script's first frame, the start screen
+bool check_start_frame(const gl_command_log& log)
+{
+    // "press [ space ] to start" and "score: 0" share one draw of 32 quads, 16 bytes a vertex,
+    // the rectangle and the line are a draw each, and both obstacles upload their 36 byte triangle
+    constexpr std::uint64_t draws = 3;
+    constexpr std::uint64_t vertices = 32 * 6 + 6 + 2;
+    constexpr std::uint64_t upload_bytes = 32 * 6 * 16 + 2 * 36;
+    std::uint64_t recorded_draws = log.get_count(gl_command::DRAW);
+    std::uint64_t recorded_vertices = log.get_amount(gl_command::DRAW);
+    std::uint64_t recorded_bytes = log.get_amount(gl_command::BUFFER_DATA) +
+                                   log.get_amount(gl_command::BUFFER_SUB_DATA) +
+                                   log.get_amount(gl_command::MAP_BUFFER);
+    if (recorded_draws != draws || recorded_vertices != vertices || recorded_bytes != upload_bytes)
+    {
+        log_error("RENDER_BENCH", "start screen took {} draws of {} vertices and {} bytes, expected {}, {} and {}",
+                  recorded_draws, recorded_vertices, recorded_bytes, draws, vertices, upload_bytes);
+        return false;
+    }
+    return true;
+}
+
+// gl_jump --render-bench [frames] [null|record]
+int run_render_benchmark(int argc, char** argv)
+{
+    std::optional<std::size_t> frames_given = argc > 2 ? parse_count(argv[2]) : 3000;
+    std::string_view mode = argc > 3 ? argv[3] : "null";
+    if (!frames_given || *frames_given == 0 || (mode != "null" && mode != "record"))
+    {
+        std::cout << "usage: gl_jump --render-bench [frames, more than 0] [null|record]" << std::endl;
+        return -1;
+    }
+    std::size_t frame_count = *frames_given;
+    bool record = mode == "record";
+
+    // no window and no driver, GL calls end in gl_backend
+    set_gl_backend_mode(record ? gl_backend_mode::RECORD : gl_backend_mode::NULL_DEVICE);
+    glbinding::initialize(get_gl_backend_proc_address, false);
+
+    AssetPack assets;
+    if (!assets.open("assets/gl_jump.pack"))
+    {
+        return -1;
+    }
+    Level level = generate_level(1, 4096);
+    gl_textrenderer textrenderer(SCREEN_WIDTH, SCREEN_HEIGHT,
+                                 gl_textrenderer::rasterize_font(assets.get("UbuntuMono-R.ttf"), 13),
+                                 ShaderSource::load(assets, "text"), {1.0f, 1.0f, 1.0f, 1.1f});
+    gl_primitives primitives(SCREEN_WIDTH, SCREEN_HEIGHT, ShaderSource::load(assets, "primitive"));
+    gl_obstacles obstacle_renderer(SCREEN_WIDTH, SCREEN_HEIGHT, ShaderSource::load(assets, "obstacle"));
+    ParticleSystem particles(16384, 600.0f, 100.0f);
+    gl_particles particle_renderer(SCREEN_WIDTH, SCREEN_HEIGHT, ShaderSource::load(assets, "particle"),
+                                   particles.get_capacity());
+    gl_renderqueue render_queue;
+    Line line;
+    Random random{3};
+    ParticleEmitter burst;
+    burst.velocity = {0.0f, 250.0f};
+    burst.velocity_spread = {250.0f, 200.0f};
+    burst.life = 0.8f;
+    FixedText<32> score_text;
+
+    // the --train input script, submitting the frame the game would draw
+    GameState game = make_game_state(level, SCREEN_WIDTH);
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration worst{};
+    std::uint64_t draws = 0;
+    std::uint64_t upload_bytes = 0;
+    for (std::size_t frame = 0; frame < frame_count; frame++)
+    {
+        get_gl_command_log().clear();
+        auto start = std::chrono::steady_clock::now();
+        game_events events = step_game(game, frame % 47 < 3, level, SCREEN_WIDTH);
+        if (events.collided)
+        {
+            burst.position = {game.rectangle.rectangle_pos_x, game.rectangle.rectangle_pos_y};
+            particles.emit(burst, 256, random);
+        }
+
+        score_text.clear();
+        score_text.append("score: ").append(game.score);
+        obstacle_renderer.set(0, game.bg_triangle);
+        obstacle_renderer.set(1, game.triangle);
+        obstacle_renderer.set_ticks(static_cast<float>(game.score));
+        if (game.current_game_state == GAME_STATE::GAME)
+        {
+            obstacle_renderer.draw(render_queue, 0, render_layer::BACKGROUND, 0.13f, 0.13f, 0.13f);
+            obstacle_renderer.draw(render_queue, 1, render_layer::WORLD, 0.7f, 0.2f, 0.0f);
+        } else
+        {
+            textrenderer.render_text(render_queue, "press [ space ] to start", 150, 300);
+        }
+        Rectangle rectangle = game.rectangle;
+        rectangle.draw(render_queue, render_layer::WORLD, primitives, 0.0f, 0.2f, 0.7f);
+        line.draw(render_queue, render_layer::WORLD, primitives, 1.0f, 1.0f, 1.0f, 0, 100, SCREEN_WIDTH, 100);
+        textrenderer.render_text(render_queue, score_text.view(), 10, SCREEN_HEIGHT - 20);
+        particles.update(1.0f / 60.0f);
+        particle_renderer.draw(render_queue, particles);
+        render_queue.execute();
+
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+        if (record && frame == 0 && !check_start_frame(get_gl_command_log()))
+        {
+            return -1;
+        }
+        draws += get_gl_command_log().get_count(gl_command::DRAW);
+        upload_bytes += get_gl_command_log().get_amount(gl_command::BUFFER_DATA) +
+                        get_gl_command_log().get_amount(gl_command::BUFFER_SUB_DATA) +
+                        get_gl_command_log().get_amount(gl_command::MAP_BUFFER);
+    }
+
+    std::cout << frame_count << " frames submitted to the " << (record ? "recording" : "null") << " backend: "
+              << std::chrono::duration<double, std::milli>(total).count() / frame_count << " ms average, "
+              << std::chrono::duration<double, std::milli>(worst).count() << " ms worst per frame" << std::endl;
+    if (record)
+    {
+        std::cout << static_cast<double>(draws) / frame_count << " draws and "
+                  << static_cast<double>(upload_bytes) / frame_count << " bytes uploaded or mapped per frame"
+                  << std::endl;
+        std::cout << "last frame's ";
+        get_gl_command_log().print_report();
+    }
+    return 0;
+}
+
+// gl_jump --timer-bench [timers] [ticks]
+int run_timer_benchmark(int argc, char** argv)
+{
+    using bench_timers = TimingWheel<std::uint32_t, 65536>;
+    std::optional<std::size_t> timers_given = argc > 2 ? parse_count(argv[2]) : 50000;
+    std::optional<std::size_t> ticks_given = argc > 3 ? parse_count(argv[3]) : 100000;
+    if (!timers_given || *timers_given == 0 || !ticks_given || *ticks_given == 0)
+    {
+        std::cout << "usage: gl_jump --timer-bench [timers, more than 0] [ticks, more than 0]" << std::endl;
+        return -1;
+    }
+    std::size_t timer_count = std::min<std::size_t>(*timers_given, 65536);
+    std::size_t tick_count = *ticks_given;
+
+    // a megabyte of pool, too much for the stack
+    auto timers = std::make_unique<bench_timers>();
+    std::vector<timer_handle> handles(timer_count);
+    Random random{11};
+    auto schedule = [&](std::uint32_t timer)
+    {
+        // anywhere from the next tick to about six minutes out
+        handles[timer] = timers->schedule(timers->get_now() + 1 + random.next_int(20000), timer);
+    };
+    for (std::uint32_t timer = 0; timer < timer_count; timer++)
+    {
+        schedule(timer);
+    }
+
+    // every tick, what fired comes back and a few pending ones are pushed back, the count stays put
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration worst{};
+    std::uint64_t fired = 0;
+    std::uint64_t batches = 0;
+    for (std::size_t tick = 0; tick < tick_count; tick++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        timers->advance([&](std::span<const std::uint32_t> batch)
+                        {
+                            batches++;
+                            fired += batch.size();
+                            for (std::uint32_t timer: batch)
+                            {
+                                schedule(timer);
+                            }
+                        });
+        for (int i = 0; i < 16; i++)
+        {
+            auto timer = static_cast<std::uint32_t>(random.next_int(static_cast<int>(timer_count)));
+            timers->cancel(handles[timer]);
+            schedule(timer);
+        }
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+    }
+
+    std::cout << timers->get_pending() << " pending timers: "
+              << std::chrono::duration<double, std::micro>(total).count() / tick_count << " us average, "
+              << std::chrono::duration<double, std::micro>(worst).count() << " us worst per tick, "
+              << static_cast<double>(fired) / tick_count << " fired in "
+              << static_cast<double>(batches) / tick_count << " batches per tick" << std::endl;
+    return 0;
+}
+
+script tutorial_prompts([[maybe_unused]] ScriptRunner& runner, script_visuals& visuals)
+{
+    co_await wait_ticks{30};
+    visuals.prompt = "hold [ space ] to keep jumping";
+    co_await until_input();
+    visuals.prompt = {};
+    co_await until_collision();
+    visuals.prompt = "jump just before the triangle gets to you";
+    co_await wait_ticks{180};
+    visuals.prompt = {};
+}
+
+script crash_flash([[maybe_unused]] ScriptRunner& runner, script_visuals& visuals)
+{
+    for (int flash = 0; flash < 6; flash++)
+    {
+        visuals.crash_flash = flash % 2 == 0;
+        co_await wait_ticks{5};
+    }
+    visuals.crash_flash = false;
+}
+
+// a script that sleeps a random number of ticks, now and then waits for a press instead, and loops
+script bench_script([[maybe_unused]] ScriptRunner& runner, std::uint64_t seed, std::uint64_t& wakes)
+{
+    Random random{seed};
+    for (;;)
+    {
+        if (random.next_int(8) == 0)
+        {
+            co_await until_input();
+        } else
+        {
+            co_await wait_ticks{static_cast<std::uint32_t>(1 + random.next_int(600))};
+        }
+        wakes++;
+    }
+}
+
+// gl_jump --script-bench [scripts] [ticks]
+int run_script_benchmark(int argc, char** argv)
+{
+    std::optional<std::size_t> scripts_given = argc > 2 ? parse_count(argv[2]) : 4000;
+    std::optional<std::size_t> ticks_given = argc > 3 ? parse_count(argv[3]) : 10000;
+    if (!scripts_given || !ticks_given || *ticks_given == 0)
+    {
+        std::cout << "usage: gl_jump --script-bench [scripts] [ticks, more than 0]" << std::endl;
+        return -1;
+    }
+    std::size_t script_count = std::min<std::size_t>(*scripts_given, ScriptRunner::capacity);
+    std::size_t tick_count = *ticks_given;
+
+    ScriptRunner scripts;
+    std::uint64_t wakes = 0;
+    for (std::size_t i = 0; i < script_count; i++)
+    {
+        scripts.start(bench_script(scripts, i, wakes));
+    }
+
+    // a press every second
+    std::uint64_t allocations = get_allocation_count();
+    std::chrono::steady_clock::duration total{};
+    std::chrono::steady_clock::duration worst{};
+    for (std::size_t tick = 0; tick < tick_count; tick++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        scripts.tick({tick % 60 == 0, false});
+        auto elapsed = std::chrono::steady_clock::now() - start;
+        total += elapsed;
+        worst = std::max(worst, elapsed);
+    }
+    allocations = get_allocation_count() - allocations;
+
+    std::cout << scripts.get_running() << " scripts: "
+              << std::chrono::duration<double, std::micro>(total).count() / tick_count << " us average, "
+              << std::chrono::duration<double, std::micro>(worst).count() << " us worst per tick, "
+              << static_cast<double>(wakes) / tick_count << " resumes per tick";
+    if (allocation_counting_enabled)
+    {
+        std::cout << ", " << allocations << " heap allocations";
+    }
+    std::cout << std::endl;
+    scripts.print_report();
+    return 0;
+}
+
+// a square of the stress scene, moving like a particle
+struct stress_rectangle
+{
+    glm::vec2 position;
+    glm::vec2 velocity;
+};
+
+// gl_jump --stress [out.csv] [budget ms]
+int run_stress_test(int argc, char** argv)
+{
+    std::string_view csv_path = argc > 2 ? argv[2] : "stress.csv";
+    std::optional<double> budget = argc > 3 ? parse_number(argv[3]) : 1000.0 / 60.0;
+    if (!budget || *budget <= 0.0)
+    {
+        std::cout << "usage: gl_jump --stress [out.csv] [budget ms, more than 0]" << std::endl;
+        return -1;
+    }
+    double budget_ms = *budget;
+    // every step has 1.25 times the load of the one before
+    const double growth = 1.25;
+    const std::size_t max_steps = 48;
+    const std::size_t warmup_frames = 30;
+    const std::size_t measured_frames = 120;
+    static_assert(measured_frames <= FrameStats::capacity);
+
+    AssetPack assets;
+    if (!assets.open("assets/gl_jump.pack"))
+    {
+        return -1;
+    }
+    std::ofstream csv{std::string(csv_path)};
+    if (!csv)
+    {
+        log_error("STRESS", "Failed to open {}", csv_path);
+        return -1;
+    }
+
+    if (!glfwInit()) return -1;
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    GLFWwindow* window = glfwCreateWindow(SCREEN_WIDTH, SCREEN_HEIGHT, "gl_jump --stress", nullptr, nullptr);
+    if (!window)
+    {
+        glfwTerminate();
+        return -1;
+    }
+    glfwMakeContextCurrent(window);
+    glbinding::initialize(glfwGetProcAddress);
+    // vsync would hide everything under the refresh interval
+    glfwSwapInterval(0);
+
+    {
+        gl_primitives primitives(SCREEN_WIDTH, SCREEN_HEIGHT, ShaderSource::load(assets, "primitive"));
+        gl_textrenderer textrenderer(SCREEN_WIDTH, SCREEN_HEIGHT,
+                                     gl_textrenderer::rasterize_font(assets.get("UbuntuMono-R.ttf"), 13),
+                                     ShaderSource::load(assets, "text"), {1.0f, 1.0f, 1.0f, 1.1f});
+        gl_renderqueue render_queue;
+        FrameStats frame_stats;
+        Line line;
+        Rectangle player(50, 50, 50, 100);
+        Random random{11};
+        std::vector<Triangle> obstacles;
+        std::vector<Triangle> bg_triangles;
+        std::vector<stress_rectangle> rectangles;
+        FixedText<32> label;
+
+        csv << "step,obstacles,texts,rectangles,background_triangles,frame_p50_ms,frame_p95_ms,frame_max_ms,"
+               "sim_ms,draw_calls,state_changes\n";
+        std::cout << "stress: " << budget_ms << " ms budget, writing " << csv_path << std::endl;
+
+        std::size_t step = 0;
+        std::uint64_t collisions = 0;
+        bool over_budget = false;
+        // the frame arena can run out before the budget does, then the queue draws nothing
+        bool queue_full = false;
+        for (; step < max_steps && !over_budget && !queue_full && !glfwWindowShouldClose(window); step++)
+        {
+            double load = std::pow(growth, static_cast<double>(step));
+            auto obstacle_count = static_cast<std::size_t>(16 * load);
+            auto text_count = static_cast<std::size_t>(8 * load);
+            auto rectangle_count = static_cast<std::size_t>(128 * load);
+            auto bg_triangle_count = static_cast<std::size_t>(16 * load);
+            // the counts only grow, what's there from the last step keeps moving
+            while (obstacles.size() < obstacle_count)
+            {
+                obstacles.emplace_back(50, 50, random.next_int(SCREEN_WIDTH), 100);
+            }
+            while (bg_triangles.size() < bg_triangle_count)
+            {
+                bg_triangles.emplace_back(100 + random.next_int(200), 100 + random.next_int(300),
+                                          random.next_int(SCREEN_WIDTH), 100);
+            }
+            while (rectangles.size() < rectangle_count)
+            {
+                rectangles.push_back({{random.next_float() * SCREEN_WIDTH, 100.0f + random.next_float() * 300.0f},
+                                      {(random.next_float() - 0.5f) * 400.0f, random.next_float() * 300.0f}});
+            }
+
+            std::uint64_t draw_calls = 0;
+            std::uint64_t state_changes = 0;
+            for (std::size_t frame = 0; frame < warmup_frames + measured_frames; frame++)
+            {
+                get_frame_arena().reset();
+                auto frame_begin = std::chrono::steady_clock::now();
+                // the game's tick: fixed step, presses on the --train rhythm
+                const float delta_time = static_cast<float>(game_tick_seconds);
+                if (frame % 47 == 0)
+                {
+                    player.jump_state = true;
+                }
+                if (player.jump_state)
+                {
+                    player.jump();
+                }
+                // at the speed a game starts with, back at the right edge once off screen
+                auto scroll = [](Triangle& triangle, int pixels)
+                {
+                    triangle.triangle_pos_x -= pixels;
+                    if (triangle.triangle_pos_x < -triangle.triangle_width)
+                    {
+                        triangle.triangle_pos_x = SCREEN_WIDTH;
+                    }
+                };
+                for (Triangle& obstacle: obstacles)
+                {
+                    scroll(obstacle, 5);
+                    if (check_collision_x(player.rectangle_pos_x + player.rectangle_width, player.rectangle_pos_x,
+                                          obstacle.triangle_pos_x, obstacle.triangle_pos_x + obstacle.triangle_width) &&
+                        check_collision_y(player.rectangle_pos_y, obstacle.triangle_height))
+                    {
+                        collisions++;
+                    }
+                }
+                for (Triangle& bg_triangle: bg_triangles)
+                {
+                    scroll(bg_triangle, 2);
+                }
+                for (stress_rectangle& rectangle: rectangles)
+                {
+                    // falls onto the line and bounces off it
+                    rectangle.velocity.y -= 600.0f * delta_time;
+                    rectangle.position += rectangle.velocity * delta_time;
+                    if (rectangle.position.y < 100.0f)
+                    {
+                        rectangle.position.y = 100.0f;
+                        rectangle.velocity.y = -rectangle.velocity.y * 0.8f;
+                    }
+                    rectangle.position.x = std::fmod(rectangle.position.x + SCREEN_WIDTH,
+                                                     static_cast<float>(SCREEN_WIDTH));
+                }
+                auto sim_end = std::chrono::steady_clock::now();
+
+                glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+                glClear(GL_COLOR_BUFFER_BIT);
+                for (Triangle& bg_triangle: bg_triangles)
+                {
+                    bg_triangle.draw(render_queue, render_layer::BACKGROUND, primitives, 0.13f, 0.13f, 0.13f);
+                }
+                for (Triangle& obstacle: obstacles)
+                {
+                    obstacle.draw(render_queue, render_layer::WORLD, primitives, 0.7f, 0.2f, 0.0f);
+                }
+                for (const stress_rectangle& rectangle: rectangles)
+                {
+                    Rectangle square(3, 3, static_cast<int>(rectangle.position.x),
+                                     static_cast<int>(rectangle.position.y));
+                    square.draw(render_queue, render_layer::WORLD, primitives, 0.6f, 0.6f, 0.6f);
+                }
+                player.draw(render_queue, render_layer::WORLD, primitives, 0.0f, 0.2f, 0.7f);
+                line.draw(render_queue, render_layer::WORLD, primitives, 1.0f, 1.0f, 1.0f, 0, 100, SCREEN_WIDTH, 100);
+                for (std::size_t text = 0; text < text_count; text++)
+                {
+                    label.clear();
+                    label.append("text ").append(static_cast<int>(text)).append(" step ")
+                            .append(static_cast<int>(step));
+                    textrenderer.render_text(render_queue, label.view(), static_cast<float>(10 + text % 4 * 120),
+                                             static_cast<float>(SCREEN_HEIGHT - 20 - text / 4 % 30 * 16));
+                }
+                render_queue.execute();
+                queue_full = queue_full || render_queue.get_draw_calls() == 0;
+                glfwSwapBuffers(window);
+                // the frame isn't done until the GPU is
+                glFinish();
+                glfwPollEvents();
+                auto frame_end = std::chrono::steady_clock::now();
+
+                if (frame < warmup_frames)
+                {
+                    continue;
+                }
+                frame_stats.record({std::chrono::duration<float, std::milli>(frame_end - frame_begin).count(),
+                                    std::chrono::duration<float, std::milli>(sim_end - frame_begin).count(),
+                                    render_queue.get_draw_calls(), 0});
+                draw_calls += render_queue.get_draw_calls();
+                state_changes += render_queue.get_state_changes();
+            }
+
+            frame_summary summary = frame_stats.summarize(measured_frames);
+            csv << step << ',' << obstacle_count << ',' << text_count << ',' << rectangle_count << ','
+                << bg_triangle_count << ',' << summary.p50_ms << ',' << summary.p95_ms << ',' << summary.max_ms << ','
+                << summary.sim_ms << ',' << static_cast<double>(draw_calls) / measured_frames << ','
+                << static_cast<double>(state_changes) / measured_frames << '\n';
+            std::cout << "  step " << step << ": " << obstacle_count << " obstacles, " << text_count << " texts, "
+                      << rectangle_count << " rectangles, " << bg_triangle_count << " background triangles, "
+                      << summary.p50_ms << " ms frame, " << summary.sim_ms << " ms sim" << std::endl;
+            over_budget = summary.p50_ms > budget_ms;
+        }
+        if (queue_full)
+        {
+            std::cout << "stress: the frame arena ran out at step " << step - 1 << ", the last row isn't drawn"
+                      << std::endl;
+        } else if (over_budget)
+        {
+            std::cout << "stress: over budget at step " << step - 1 << ", " << collisions << " collisions simulated"
+                      << std::endl;
+        } else
+        {
+            std::cout << "stress: still within budget after " << step << " steps" << std::endl;
+        }
+    }
+    glfwTerminate();
+    return 0;
+}
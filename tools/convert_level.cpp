@@ -0,0 +1,155 @@
+// gl_jump_level <input.txt> <output.level>
+// gl_jump_level --generate <seed> <length> <output.level>
+// turns a text course into a level file, or writes a random one of any length
+//
+// text format, one span per line, '#' starts a comment:
+//
+//   obstacles                       spans below go on the obstacle track
+//   triangle 50 50 700              width, height, spacing past the left edge
+//   triangle 50 80 1200 x4          the same span four times
+//   decorations                     spans below go on the background track
+//   decoration 300 400 900
+#include <charconv>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "Level/Level.h"
+#include "Logger/Logger.h"
+
+namespace
+{
+    // the whole argument as a count, nothing if it isn't one
+    std::optional<std::uint64_t> parse_count(std::string_view text)
+    {
+        std::uint64_t value = 0;
+        auto [end, error] = std::from_chars(text.data(), text.data() + text.size(), value);
+        if (error != std::errc() || end != text.data() + text.size())
+        {
+            return std::nullopt;
+        }
+        return value;
+    }
+
+    int print_usage()
+    {
+        std::cout << "usage: gl_jump_level <input.txt> <output.level>" << std::endl;
+        std::cout << "       gl_jump_level --generate <seed> <length, more than 0> <output.level>" << std::endl;
+        return 1;
+    }
+
+    bool parse_course(std::istream& input, std::vector<LevelSpan>& obstacles, std::vector<LevelSpan>& decorations)
+    {
+        std::vector<LevelSpan>* track = nullptr;
+        std::string line;
+        for (int line_number = 1; std::getline(input, line); line_number++)
+        {
+            if (std::size_t comment = line.find('#'); comment != std::string::npos)
+            {
+                line.resize(comment);
+            }
+            std::istringstream words(line);
+            std::string word;
+            if (!(words >> word))
+            {
+                continue;
+            }
+
+            if (word == "obstacles" || word == "decorations")
+            {
+                track = word == "obstacles" ? &obstacles : &decorations;
+                continue;
+            }
+            SpanType type = word == "triangle" ? SpanType::TRIANGLE : SpanType::DECORATION;
+            if (word != "triangle" && word != "decoration")
+            {
+                log_error("LEVEL", "line {}: unknown span type {}", line_number, word);
+                return false;
+            }
+            if (!track || (track == &obstacles) != (type == SpanType::TRIANGLE))
+            {
+                log_error("LEVEL", "line {}: {} doesn't belong on this track", line_number, word);
+                return false;
+            }
+
+            LevelSpan span{type};
+            if (!(words >> span.width >> span.height >> span.spacing) || span.width <= 0 || span.height <= 0 ||
+                span.spacing < 0 || span.width > 0xFFFF || span.height > 0xFFFF || span.spacing > 0xFFFF)
+            {
+                log_error("LEVEL", "line {}: expected width height spacing, each 0 to 65535 and the sizes above 0",
+                          line_number);
+                return false;
+            }
+            int repeat = 1;
+            if (words >> word)
+            {
+                if (word.size() < 2 || word[0] != 'x' || (repeat = std::atoi(word.c_str() + 1)) <= 0)
+                {
+                    log_error("LEVEL", "line {}: expected a repeat like x4", line_number);
+                    return false;
+                }
+            }
+            track->insert(track->end(), repeat, span);
+        }
+        if (obstacles.empty() || decorations.empty())
+        {
+            log_error("LEVEL", "a course needs at least one obstacle and one decoration");
+            return false;
+        }
+        return true;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<LevelSpan> obstacles;
+    std::vector<LevelSpan> decorations;
+    std::string output_path;
+
+    if (argc == 5 && std::string(argv[1]) == "--generate")
+    {
+        std::optional<std::uint64_t> seed = parse_count(argv[2]);
+        std::optional<std::uint64_t> length = parse_count(argv[3]);
+        // an empty course is refused for text input too
+        if (!seed || !length || *length == 0)
+        {
+            return print_usage();
+        }
+        generate_course(*seed, *length, obstacles, decorations);
+        output_path = argv[4];
+    } else if (argc == 3)
+    {
+        std::ifstream input(argv[1]);
+        if (!input)
+        {
+            log_error("LEVEL", "Failed to read {}", argv[1]);
+            return 1;
+        }
+        if (!parse_course(input, obstacles, decorations))
+        {
+            log_error("LEVEL", "in {}", argv[1]);
+            return 1;
+        }
+        output_path = argv[2];
+    } else
+    {
+        return print_usage();
+    }
+
+    std::vector<std::byte> image = write_level(obstacles, decorations);
+    std::ofstream output(output_path, std::ios::binary);
+    output.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+    if (!output)
+    {
+        log_error("LEVEL", "Failed to write {}", output_path);
+        return 1;
+    }
+    std::cout << "wrote " << obstacles.size() << " obstacles and " << decorations.size() << " decorations to "
+              << output_path << " (" << image.size() << " bytes)" << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+// gl_jump_pack <output.pack> <assets root> <file>...
+// writes every file into a single asset pack, named by its path relative to the root
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "AssetPack/AssetPack.h"
+#include "Logger/Logger.h"
+
+namespace
+{
+    struct source_asset
+    {
+        std::string name;
+        AssetType type;
+        std::vector<char> data;
+    };
+
+    AssetType type_from_extension(const std::filesystem::path& path)
+    {
+        std::string extension = path.extension().string();
+        if (extension == ".ttf" || extension == ".otf") return AssetType::FONT;
+        if (extension == ".vert" || extension == ".frag" || extension == ".glsl") return AssetType::SHADER;
+        if (extension == ".png" || extension == ".tex") return AssetType::TEXTURE;
+        return AssetType::RAW;
+    }
+
+    std::uint64_t align_up(std::uint64_t value)
+    {
+        return (value + asset_pack_alignment - 1) / asset_pack_alignment * asset_pack_alignment;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    if (argc < 4)
+    {
+        std::cout << "usage: gl_jump_pack <output.pack> <assets root> <file>..." << std::endl;
+        return 1;
+    }
+    std::filesystem::path root = argv[2];
+
+    std::vector<source_asset> assets;
+    for (int i = 3; i < argc; i++)
+    {
+        std::filesystem::path path = argv[i];
+        std::string name = std::filesystem::relative(path, root).generic_string();
+        if (name.size() >= asset_pack_name_size)
+        {
+            log_error("PACK", "asset name too long: {}", name);
+            return 1;
+        }
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            log_error("PACK", "Failed to read {}", path.string());
+            return 1;
+        }
+        assets.push_back({name, type_from_extension(path),
+                          {std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>()}});
+    }
+    // AssetPack looks names up with a binary search
+    std::sort(assets.begin(), assets.end(), [](const source_asset& a, const source_asset& b)
+    {
+        return a.name < b.name;
+    });
+
+    AssetPackHeader header = {};
+    std::memcpy(header.magic, asset_pack_magic, sizeof(asset_pack_magic));
+    header.version = asset_pack_version;
+    header.entry_count = assets.size();
+    header.toc_offset = align_up(sizeof(AssetPackHeader));
+
+    std::vector<AssetPackEntry> entries(assets.size());
+    std::uint64_t offset = align_up(header.toc_offset + entries.size() * sizeof(AssetPackEntry));
+    for (std::size_t i = 0; i < assets.size(); i++)
+    {
+        std::memcpy(entries[i].name, assets[i].name.c_str(), assets[i].name.size());
+        entries[i].type = assets[i].type;
+        entries[i].offset = offset;
+        entries[i].size = assets[i].data.size();
+        offset = align_up(offset + assets[i].data.size());
+    }
+    header.file_size = offset;
+
+    std::vector<char> pack(header.file_size, 0);
+    std::memcpy(pack.data(), &header, sizeof(header));
+    std::memcpy(pack.data() + header.toc_offset, entries.data(), entries.size() * sizeof(AssetPackEntry));
+    for (std::size_t i = 0; i < assets.size(); i++)
+    {
+        std::copy(assets[i].data.begin(), assets[i].data.end(), pack.begin() + entries[i].offset);
+    }
+
+    std::ofstream output(argv[1], std::ios::binary);
+    output.write(pack.data(), pack.size());
+    if (!output)
+    {
+        log_error("PACK", "Failed to write {}", argv[1]);
+        return 1;
+    }
+    std::cout << "packed " << assets.size() << " assets into " << argv[1] << " (" << pack.size() << " bytes)"
+              << std::endl;
+    return 0;
+}